@@ -43,6 +43,22 @@ Debug function macro's
 /*! The actual debug function. There shouldn't be any reason to change this. */
 #define dprint(...)             fprint(debug_putchar, __VA_ARGS__)
 
+/*! Amount of debug modules available for project code, numbered from DMOD_USER
+    (see debug.h). Each module costs one byte of RAM for it's runtime level. */
+#define DEBUG_USERMODULES       4
+
+/*! When enabled, init() records a timestamp for every initcall (see initcall.h),
+    including the basic system it sets up itself, so initcall_report() can show where
+    the boot time goes. */
+#define INITCALL_TIMING         0
+
+/*! The timer used for the initcall timestamps (0 or 1). It's started by init() and
+    left running, counting microseconds. It can't be a timer used by one of the
+    drivers (the system time, capture, the kernel, ...), as those reprogram it while
+    the initcalls run. The application can still use it; but timestamps of lazy initcalls run after
+    that are meaningless. */
+#define INITCALL_TIMER          1
+
 /* Include any headerfiles needed for the functions defined above */
 #include <uart.h>
 #include <print.h>
@@ -74,6 +74,98 @@ Configuration and general defines
     program execution. */
 #define HANDLE_SWI          0
 
+/*! When enabled, IRQHandler (crt0.S) re-enables IRQs before calling the handler of
+    the current interrupt, so a higher priority vectored interrupt can preempt a
+    lower priority one that is still being handled (the VIC holds off interrupts of
+    the same and lower priority until the handler is done).
+    Handlers then run in System mode, on the System mode stack; so keep an eye on
+    STACKSIZE_SYS. The __enable_nested_interrupts() and __disable_nested_interrupts()
+    macros from irq.h must not be used with this enabled. */
+#define IRQ_NESTED          0
+
+/*! When enabled, the IRQ vector loads the handler address from the VIC itself
+    ('ldr pc,[pc,#-0xFF0]'). A handler installed with the IRQDIRECT flag (see vic_setup())
+    is then jumped to straight away, without going through IRQHandler in crt0.S. It must
+    be declared with IRQDIRECTFUNC (see types.h) and acknowledge the VIC itself
+    (vic_acknowledge(), see vic.h). Direct handlers are never nested (see IRQ_NESTED).
+    Handlers installed without the flag work as before; their VIC slot points to a
+    small stub in crt0.S that does what IRQHandler does. */
+#define IRQ_DIRECT          0
+
+/*! When enabled, vic_init() installs a dispatcher as the non-vectored IRQ handler.
+    Channels set up with PRIO_NONVECTOR (or that didn't get a slot from vic_setupclass())
+    then keep their own handler, in a table indexed by channel. All pending non-vectored
+    channels are handled in one go, lowest channel first. The handler given to vic_init()
+    (or vic_setdefaulthandler()) is called for IRQ's without a handler of their own */
+#define VIC_DISPATCH        0
+
+/*! By default FIQ's are not handled; when one fires, program execution stops in
+    __HaltFiq() (see drivers/exceptions.c). To handle one designated interrupt source
+    (an ADC, EINT or timer match for example) as FIQ, set this to:
+      1   A C handler, installed with fiq_init(), is called from a small assembly
+          entry in crt0.S. It gets a pointer to the banked r8-r12, which keep their
+          value between FIQ's and can be used for state (a sample pointer and count,
+          for example). STACKSIZE_FIQ must be 0x28, plus what the handler uses (the
+          Linkerscript enlarges it to 0x100 at least).
+      2   The FIQ vector jumps straight to your own assembly function fiq_asmhandler().
+          It can use the banked r8-r12 without saving them, and returns with
+          'subs pc, lr, #4'. This is the fastest option.
+    Either way, the VIC is not involved at all when the FIQ fires. See fiq.h */
+#define FIQ_HANDLER         0
+
+/*! Deferred work (see defer.h): the amount of work items that can be waiting, for
+    each priority. Must be a power of 2, up to 128 */
+#define DEFER_QUEUELENGTH   8
+
+/*! When set to a VIC channel number, deferred work is run from a software triggered
+    (VICSoftInt) IRQ on that channel, in VIC slot PRIO_DEFER (see vic.h). The
+    channel should not be used for anything else; 2 (VIC_CH_DBGCOMMRX) is a good
+    choice when no debugger uses the debug comms channel. When 0, deferred work is
+    only run when the main loop calls defer_run() */
+#define DEFER_SOFTINT       0
+
+/*! Enable the preemptive task kernel (see kernel.h). Cannot be combined with IRQ_NESTED */
+#define KERNEL              0
+
+/*! Kernel tick rate, in Hz. Timeouts and task_sleep() are in ticks */
+#define KERNEL_TICK         100
+
+/*! The timer used for the kernel tick (0 or 1). It can't be used for anything else */
+#define KERNEL_TIMER        0
+
+/*! The VIC channel used for the software interrupt that switches tasks, in slot
+    PRIO_KERNEL (see vic.h). It can't be used for anything else; 3 (VIC_CH_DBGCOMMTX)
+    is a good choice when no debugger uses the debug comms channel */
+#define KERNEL_SOFTINT      3
+
+/*! Enable the software timers (see swtimer.h). Timer SWTIMER_TIMER (0 or 1) then runs
+    free with a tick of SWTIMER_USEC microseconds, and it's MR0 interrupts at the next
+    deadline. It can't be used for anything else. Costs about 800 bytes of RAM */
+#define SWTIMER             0
+#define SWTIMER_TIMER       0
+#define SWTIMER_USEC        1
+
+/*! Enable the 64 bit system time (see timebase.h), on timer TIMEBASE_TIMER (0 to 3; 2 and
+    3 are 16 bit timers, on the LPC2101/2/3 only). It counts (1<<TIMEBASE_SHIFT) ticks per
+    microsecond, so PCLK must be a multiple of that in MHz. delay_us() and friends (see
+    delay.h) use it instead of calibrated busy loops when it's enabled */
+#define TIMEBASE            0
+#define TIMEBASE_TIMER      1
+#define TIMEBASE_SHIFT      0
+
+/*! Enable the capture driver (see capture.h), on timer CAPTURE_TIMER (0 to 3) */
+#define CAPTURE             0
+#define CAPTURE_TIMER       1
+
+/*! Enable the match output waveforms (see waveform.h), on timer WAVEFORM_TIMER (0 to 3) */
+#define WAVEFORM            0
+#define WAVEFORM_TIMER      0
+
+/*! Enable the timer PWM channels of the LPC2101/2/3 (see timerpwm.h), on timer
+    TIMERPWM_TIMER (0 to 3) */
+#define TIMERPWM            0
+#define TIMERPWM_TIMER      2
+
 /********************
   Debug configuration
 */
@@ -89,6 +181,12 @@ Configuration and general defines
     For debug output settings, see config-debug.h. */
 #define DEBUG               D_ERROR
 
+/*! The runtime debug level each module (see debug.h) starts with. Messages up to
+    the DEBUG level above are compiled in, but only those up to this level are
+    actually printed. The level of a single module can be raised at runtime with
+    debug_setlevel(), without rebuilding and without enabling the others. */
+#define DEBUG_DEFAULTLEVEL  D_ERROR
+
 /*! When this is set to '1', the ASSERT macro is enabled. When set to
     '0' ASSERT is disabled (it'll be an empty macro) .
     Note that the default assert macro uses dprint() for the output,
@@ -100,6 +198,18 @@ Configuration and general defines
     non-true expression. */
 #define ASSERT_CALLBACK     1
 
+/*! When enabled, IRQHandler (crt0.S) timestamps every IRQ it dispatches, and keeps
+    per VIC channel a count, the total and maximum time spent in the handler, and
+    the maximum entry latency (see irqprofile.h). Costs about 1kB of RAM, and
+    some time on every IRQ. Handlers installed with IRQDIRECT are not profiled. */
+#define IRQPROFILE          0
+
+/*! The timer used by IRQPROFILE (0 or 1). irqprofile_start() makes it run free at
+    PCLK speed; the application can still use it for anything that doesn't change
+    the prescaler or reset the counter. It can't be a timer used by one of the
+    drivers (the system time, capture, the kernel, ...). */
+#define IRQPROFILE_TIMER    1
+
 /********************
   Exception handling
 */
@@ -135,11 +245,18 @@ Configuration and general defines
 /*! Some drivers contain wait-loops, used to wait for an interrupt-based event to
     occur. It is possible to put the CPU to sleep in these waitloops to preserve
     power. When the following setting is enabled, the CPU will go in idle-mode
-    in these wait-loops.
-    Note that this isn't used very much yet, so only enable this if you like to
-    test it. */
+    in these wait-loops, and in event_run() (see event.h) when there's nothing
+    to do. */
 #define SLEEPWHENWAITING    1
 
+/*! When enabled, event_run() keeps track of the time it spends idle, for
+    event_idlepercent(). It's measured with timer EVENT_TIMER (0 or 1), which is
+    started at PCLK speed when it isn't running already; the application can still
+    use it for anything that doesn't change the prescaler or reset the counter. It
+    can't be a timer used by one of the drivers (the system time, capture, ...). */
+#define EVENT_IDLESTATS     0
+#define EVENT_TIMER         1
+
 /*! Some newer LPC2000 devices support so called 'fast-I/O', where the I/O is
     addressed though the local bus instead of the (slower) APB.
     When the following is set, 'fast-I/O' will be used if available.
@@ -152,6 +269,16 @@ Configuration and general defines
     FlashMagic works as supposed. */
 #define CODEPROTECTION      0
 
+/*! When running from ROM, interrupt response time suffers from flash wait states
+    and MAM misses. When the following is enabled, the whole interrupt path is placed
+    in RAM: a copy of the exception vectors (remapped to address 0 with MEMMAP), the
+    IRQ handler in crt0.S, the UART interrupt handlers and the ringbuffer functions.
+    Your own interrupt handlers (timer, ADC, ...) can be added with the IRQFUNC macro
+    (see types.h). The RAM cost is reported after linking.
+    Ignored when running from RAM (everything is in RAM already). Cannot be combined
+    with DATA_LOCATION, since the vectors have to be at the start of RAM. */
+#define IRQ_IN_RAM          0
+
 /*! When the following is enabled, it's possible to detect a soft reset. The function
     getresetcause() can return RESET_POWERUP (hard-reset), RESET_WATCHDOG (watchdog timeout)
     or RESET_SOFT (software reset). To be able to detect a software reset, a location in RAM
@@ -176,7 +303,8 @@ Configuration and general defines
     __STACK_SIZE_SYS__
 */
 
-/*! Stacksize for FIQ mode. Not used by default, so minimal size */
+/*! Stacksize for FIQ mode. Not used by default, so minimal size. When FIQ_HANDLER
+    is 1 (see above), it's enlarged to at least 0x100 */
 #define STACKSIZE_FIQ       0x4
 /*! Stacksize for IRQ mode. Used quite often, so set to a reasonably big size */
 #define STACKSIZE_IRQ       0x200
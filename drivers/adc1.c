@@ -32,6 +32,7 @@ Analog to digital converter 1 driver
 #include "registers.h"
 #include "adc_bits.h"
 
+
 error_t adc1_init(const unsigned char channel)
 /*!
   Initialise ADC
@@ -93,14 +94,14 @@ unsigned short adc1_get(const unsigned char channel, const unsigned char speed)
     do {
         result = AD1DRArray[channel];
         if (result & ADC_OVERRUN) {
-            dprint("ADC1 overrun!\n\r");
+            derror(DMOD_ADC, "ADC1 overrun!\n\r");
         }
     } while(!(result&ADC_DONE));
     /* Conversion is complete, return result */
     return ADC_READRESULT(result);
 }
 
-void adc1_startburst(const unsigned char channel, const unsigned int trigger, const unsigned char edge, const unsigned char speed, const unsigned char clocks, const FUNCTION handler)
+error_t adc1_startburst(const unsigned char channel, const unsigned int trigger, const unsigned char edge, const unsigned char speed, const unsigned char clocks, const FUNCTION handler)
 /*!
   Start AD-converter in burstmode. Each time a conversion is complete an
   interrupt occurs, which in turn calls the function 'handler'.
@@ -130,8 +131,14 @@ void adc1_startburst(const unsigned char channel, const unsigned int trigger, co
     }
   \endcode
   And so on; each enabled channel should be checked.
+  Returns BUSY when PRIO_ADC1 is the VIC slot of a software interrupt in use (see vic.h).
 */
 {
+    if(vic_softintslot(PRIO_ADC1)) {
+        derror(DMOD_ADC, "ADC1: VIC slot %i is taken\n\r", PRIO_ADC1);
+        return BUSY;
+    }
+
     /* First set channel, clock and enable AD converter. Clock results
        from dividing PCLK by (the clockvalue set here + 1) */
     AD1CR = ((edge&0x01)<<27) | ADC_PDN | ((clocks&0x7)<<17) | ADC_BURST | (speed<<8) | (channel&0xFF);
@@ -145,6 +152,8 @@ void adc1_startburst(const unsigned char channel, const unsigned int trigger, co
 
     /* OK, start conversion */
     AD1CR |= ADC_BURST;
+
+    return GOOD;
 }
 
 void adc1_stopburst(void)
@@ -0,0 +1,393 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    capture.c:
+              Timer capture driver
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -See capture.h for how to use this.
+            -The timer runs free; all time differences are taken modulo it's width, so a period
+             is measured correctly as long as it's shorter than one timer wrap.
+            -The edge bits of a channel in CCR are in the same order as CAPTURE_RISING and
+             CAPTURE_FALLING, so those are written to CCR as they are.
+            -With CAPTURE_BOTH, CCR captures both edges, and the interrupt handler tells them
+             apart by the level of the pin (IOPIN shows it whatever the pin's function). The
+             capture register and the level are read until the capture register holds still,
+             so they belong to the same edge. Another edge right after the flag was cleared
+             gives a second interrupt for the same capture; it's recognized and skipped.
+
+*/
+/*!
+\file
+Timer capture driver
+*/
+#include <config.h>
+
+#if CAPTURE
+#include <capture.h>
+#include <timer.h>
+#include <ringbuffer.h>
+#include <irq.h>
+#include <io.h>
+#include <err.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if CAPTURE_TIMER < 0 || CAPTURE_TIMER > 3
+#error "CAPTURE_TIMER must be 0 to 3"
+#endif
+#if (CAPTURE_TIMER == 2 && !defined TIMER2_ENABLED) || (CAPTURE_TIMER == 3 && !defined TIMER3_ENABLED)
+#error "This MCU doesn't have the timer selected by CAPTURE_TIMER"
+#endif
+#if (KERNEL && KERNEL_TIMER == CAPTURE_TIMER) || (SWTIMER && SWTIMER_TIMER == CAPTURE_TIMER) || \
+    (TIMEBASE && TIMEBASE_TIMER == CAPTURE_TIMER)
+#error "The capture driver needs a timer of it's own"
+#endif
+
+#define __CAPTURE_TIMER(n, name)    timer##n##_##name
+#define CAPTURE_TIMERFN(n, name)    __CAPTURE_TIMER(n, name)
+#define __CAPTURE_REG(timer, reg)   T##timer##reg
+#define CAPTURE_REG(timer, reg)     __CAPTURE_REG(timer, reg)
+#define CAPTURE_IR                  CAPTURE_REG(CAPTURE_TIMER, IR)
+#define CAPTURE_TCR                 CAPTURE_REG(CAPTURE_TIMER, TCR)
+#define CAPTURE_TC                  CAPTURE_REG(CAPTURE_TIMER, TC)
+#define CAPTURE_PR                  CAPTURE_REG(CAPTURE_TIMER, PR)
+#define CAPTURE_MCR                 CAPTURE_REG(CAPTURE_TIMER, MCR)
+/* CCR is a RTC register too, so it can't be passed to CAPTURE_REG() */
+#define __CAPTURE_CCR(timer)        T##timer##CCR
+#define CAPTURE_CCRREG(timer)       __CAPTURE_CCR(timer)
+#define CAPTURE_CCR                 CAPTURE_CCRREG(CAPTURE_TIMER)
+#define CAPTURE_CTCR                CAPTURE_REG(CAPTURE_TIMER, CTCR)
+
+/* Counter width */
+#if CAPTURE_TIMER < 2
+#define CAPTURE_MASK                0xFFFFFFFFUL
+typedef unsigned long capturereg_t;
+#else
+#define CAPTURE_MASK                0xFFFFUL
+typedef unsigned short capturereg_t;
+#endif
+
+/* The CCR bits of a channel */
+#define CAPTURE_CCRBITS(channel, bits)  ((bits) << (3*(channel)))
+#define CAPTURE_CCRMASK(channel)        CAPTURE_CCRBITS(channel, 7)
+
+/* The capture registers; CR3 doesn't exist on the 16 bit timers */
+static volatile capturereg_t * const capture_registers[CAPTURE_CHANNELS] = {
+    &CAPTURE_REG(CAPTURE_TIMER, CR0),
+    &CAPTURE_REG(CAPTURE_TIMER, CR1),
+    &CAPTURE_REG(CAPTURE_TIMER, CR2),
+#if CAPTURE_CHANNELS > 3
+    &CAPTURE_REG(CAPTURE_TIMER, CR3),
+#endif
+};
+
+typedef struct capturechannel {
+    ringbufferctrl_t buffer;
+    bool buffered;                  /* Time stamps go to 'buffer' */
+    unsigned char edges;            /* What to capture, 0 when stopped */
+    unsigned int pinmask;           /* The input pin in IOPIN, with CAPTURE_BOTH */
+    unsigned char lastedge;         /* Edge of the last time stamp, 0 before the first */
+    unsigned int lasttime;          /* And it's time */
+    bool seen;                      /* A period edge was seen */
+    unsigned int last;              /* Last period edge (rising, unless only falling edges are captured) */
+    unsigned int period;            /* Ticks between the last two period edges */
+    unsigned int high;              /* Ticks between the last rising and falling edge */
+    unsigned int lost;              /* Time stamps that didn't fit in 'buffer' */
+} capturechannel_t;
+
+static capturechannel_t capture_channels[CAPTURE_CHANNELS];
+
+/* Ticks per second, 0 in counter mode. And the input counted in counter mode */
+static unsigned int capture_tickrate;
+static unsigned char capture_countinput = 0xFF;
+
+static void capture_setup(const unsigned int prescaler, const unsigned char countcontrol);
+static IRQFUNC void capture_intHandler(void);
+
+error_t capture_init(const unsigned int prescaler)
+/*!
+  Start the CAPTURE_TIMER free running, counting PCLK/('prescaler'+1). Stops all channels
+*/
+{
+    capture_setup(prescaler, BIT_CTCR_TIMER);
+    capture_tickrate = PCLK/(prescaler+1);
+    capture_countinput = 0xFF;
+
+    return GOOD;
+}
+
+error_t capture_counter(const unsigned char input, const unsigned char edges)
+/*!
+  Have the CAPTURE_TIMER count the 'edges' (CAPTURE_RISING, _FALLING or _BOTH) on capture
+  input 'input' instead of time; no interrupt is involved. Stops all channels. Returns
+  INVALID for a bad input or edge
+*/
+{
+    if(input >= CAPTURE_CHANNELS || edges == 0 || edges > CAPTURE_BOTH) {
+        return INVALID;
+    }
+
+    /* CAPTURE_RISING, _FALLING and _BOTH are the CTCR counter modes */
+    capture_setup(0, edges | BIT_CTCR_INPUT(input));
+    capture_tickrate = 0;
+    capture_countinput = input;
+
+    return GOOD;
+}
+
+unsigned int capture_count(void)
+/*!
+  Return the counter of the CAPTURE_TIMER; the amount of edges counted in counter mode. It
+  wraps at the timer width
+*/
+{
+    return CAPTURE_TC;
+}
+
+error_t capture_start(const unsigned char channel, const unsigned char edges, const unsigned char pin, captureevent_t *buffer, const unsigned int length)
+/*!
+  Capture the 'edges' (CAPTURE_RISING, _FALLING or _BOTH) on 'channel'. With CAPTURE_BOTH,
+  'pin' is the port 0 pin (0 to 31) the channel's CAP input is on, read to tell the edges
+  apart; it's ignored otherwise. When 'buffer' is not NULL, the time stamps are stored in
+  it, and read with capture_read(); it holds 'length'-1 of them. Without it, only the
+  period and duty cycle are kept. Restarts the channel when it was running. Returns
+  INVALID for a bad channel, edge or pin, or for the input used by counter mode
+*/
+{
+    capturechannel_t *c;
+    interrupt_t status;
+
+    if(channel >= CAPTURE_CHANNELS || channel == capture_countinput || edges == 0 || edges > CAPTURE_BOTH) {
+        return INVALID;
+    }
+    if(edges == CAPTURE_BOTH && pin > 31) {
+        return INVALID;
+    }
+
+    c = &capture_channels[channel];
+
+    __critical_enter(status);
+
+    CAPTURE_CCR &= ~CAPTURE_CCRMASK(channel);
+    CAPTURE_IR = (BIT_IR_CR0 << channel);
+
+    c->buffered = (buffer != NULL);
+    if(c->buffered) {
+        ringbuffer_init(&c->buffer, (unsigned char *)buffer, length*sizeof(captureevent_t));
+    }
+    c->edges = edges;
+    if(edges == CAPTURE_BOTH) {
+        c->pinmask = (1UL<<pin);
+    }
+    c->lastedge = 0;
+    c->seen = FALSE;
+    c->period = 0;
+    c->high = 0;
+    c->lost = 0;
+
+    CAPTURE_CCR |= CAPTURE_CCRBITS(channel, edges | BIT_CCR_CAP0I);
+
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+error_t capture_stop(const unsigned char channel)
+/*!
+  Stop capturing on 'channel'. The time stamps in it's buffer can still be read
+*/
+{
+    interrupt_t status;
+
+    if(channel >= CAPTURE_CHANNELS) {
+        return INVALID;
+    }
+
+    __critical_enter(status);
+    CAPTURE_CCR &= ~CAPTURE_CCRMASK(channel);
+    capture_channels[channel].edges = 0;
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+unsigned int capture_read(const unsigned char channel, captureevent_t *events, const unsigned int count)
+/*!
+  Move up to 'count' time stamps of 'channel' to 'events', oldest first. Returns how many
+  there were
+*/
+{
+    if(channel >= CAPTURE_CHANNELS || !capture_channels[channel].buffered) {
+        return 0;
+    }
+    return ringbuffer_read(&capture_channels[channel].buffer, events, sizeof(captureevent_t), count);
+}
+
+unsigned int capture_lost(const unsigned char channel)
+/*!
+  Return the amount of time stamps of 'channel' that were dropped because it's buffer
+  was full
+*/
+{
+    if(channel >= CAPTURE_CHANNELS) {
+        return 0;
+    }
+    return capture_channels[channel].lost;
+}
+
+unsigned int capture_period(const unsigned char channel)
+/*!
+  Return the last measured period on 'channel', in timer ticks; 0 until two rising edges
+  (or falling edges, when only those are captured) were seen
+*/
+{
+    if(channel >= CAPTURE_CHANNELS) {
+        return 0;
+    }
+    return capture_channels[channel].period;
+}
+
+unsigned int capture_frequency(const unsigned char channel)
+/*!
+  Return the last measured frequency on 'channel', in Hz; 0 when the period isn't known,
+  or in counter mode
+*/
+{
+    unsigned int period = capture_period(channel);
+
+    if(period == 0) {
+        return 0;
+    }
+    return (capture_tickrate + period/2) / period;
+}
+
+unsigned int capture_duty(const unsigned char channel)
+/*!
+  Return the last measured duty cycle (high time) on 'channel', in 0.1%. Only with
+  CAPTURE_BOTH; 0 otherwise, and when the period isn't known yet
+*/
+{
+    capturechannel_t *c;
+    interrupt_t status;
+    unsigned int period;
+    unsigned int high;
+
+    if(channel >= CAPTURE_CHANNELS) {
+        return 0;
+    }
+    c = &capture_channels[channel];
+
+    __critical_enter(status);
+    period = c->period;
+    high = c->high;
+    __critical_exit(status);
+
+    if(c->edges != CAPTURE_BOTH || period == 0 || high > period) {
+        return 0;
+    }
+    return ((unsigned long long)high * 1000) / period;
+}
+
+static void capture_setup(const unsigned int prescaler, const unsigned char countcontrol)
+/*
+  (Re)start the timer with all channels stopped, and the interrupt handler installed
+*/
+{
+    unsigned char channel;
+
+    CAPTURE_TIMERFN(CAPTURE_TIMER, init)(CAPTURE_MASK, prescaler, capture_intHandler);
+    CAPTURE_TCR = BIT_TCR_RESET;
+    CAPTURE_MCR = 0;
+    CAPTURE_CCR = 0;
+    CAPTURE_CTCR = countcontrol;
+    CAPTURE_IR = 0xFF;
+    for(channel=0;channel<CAPTURE_CHANNELS;channel++) {
+        capture_channels[channel].edges = 0;
+    }
+    CAPTURE_TCR = BIT_TCR_ENABLE;
+}
+
+static void capture_intHandler(void)
+/*
+  Timer interrupt; store the captured time stamps and update the period and high time
+*/
+{
+    capturechannel_t *c;
+    captureevent_t event;
+    unsigned char channel;
+    unsigned char periodedge;
+    unsigned char prevedge;
+    bool high;
+
+    for(channel=0;channel<CAPTURE_CHANNELS;channel++) {
+        if(!(CAPTURE_IR & (BIT_IR_CR0 << channel))) {
+            continue;
+        }
+        CAPTURE_IR = (BIT_IR_CR0 << channel);
+
+        c = &capture_channels[channel];
+        if(c->edges == 0) {
+            /* Stopped just after the capture */
+            continue;
+        }
+        if(c->edges == CAPTURE_BOTH) {
+            /* The pin is high after a rising edge. When another edge comes in while reading,
+               read again */
+            do {
+                event.time = *capture_registers[channel];
+                high = (iopin0 & c->pinmask) != 0;
+            } while(event.time != *capture_registers[channel]);
+            event.edge = high ? CAPTURE_RISING : CAPTURE_FALLING;
+
+            if(event.edge == c->lastedge && event.time == c->lasttime) {
+                /* Already handled, the interrupt came from an edge read last time */
+                continue;
+            }
+        }
+        else {
+            event.time = *capture_registers[channel];
+            event.edge = c->edges;
+        }
+        prevedge = c->lastedge;
+        c->lastedge = event.edge;
+        c->lasttime = event.time;
+
+        periodedge = (c->edges & CAPTURE_RISING) ? CAPTURE_RISING : CAPTURE_FALLING;
+        if(event.edge == periodedge) {
+            if(c->seen) {
+                c->period = (event.time - c->last) & CAPTURE_MASK;
+            }
+            else {
+                c->seen = TRUE;
+            }
+            c->last = event.time;
+        }
+        else if(prevedge == periodedge) {
+            if(c->seen) {
+                c->high = (event.time - c->last) & CAPTURE_MASK;
+            }
+        }
+        else {
+            /* A falling edge after a falling edge; the rising edge in between was missed,
+               so 'last' is a period old. Start over */
+            c->seen = FALSE;
+        }
+
+        if(c->buffered) {
+            if(ringbuffer_write(&c->buffer, &event, sizeof(captureevent_t), 1) == 0) {
+                c->lost++;
+            }
+        }
+    }
+}
+
+#endif /* CAPTURE */
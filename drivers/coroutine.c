@@ -0,0 +1,149 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    coroutine.c:
+                Stackful coroutines
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -See coroutine.h for how to use this; the register swap is found in coroutine_ARM.S
+
+*/
+/*!
+\file
+Stackful coroutines
+*/
+#include <coroutine.h>
+#include <err.h>
+#include <gcc.h>
+
+/* What __coroutine_swap() loads for a new coroutine: r4-r11, and lr */
+#define COROUTINE_FRAMEWORDS    9
+
+/* The coroutine that's running, NULL when none */
+static coroutine_t *coroutine_running;
+
+/* Called from __coroutine_entry (coroutine_ARM.S) */
+void __coroutine_main(coroutine_t *coroutine) __noreturn;
+
+error_t coroutine_start(coroutine_t *coroutine, const COROUTINEFUNCTION function, void *arg)
+/*!
+  Prepare 'coroutine' (defined with COROUTINE()) to call 'function' with argument 'arg'.
+  It runs up to it's first yield on the first coroutine_resume(). Returns BUSY when
+  it's running already
+*/
+{
+    unsigned int *sp;
+    unsigned int i;
+
+    if(coroutine->running) {
+        return BUSY;
+    }
+
+    for(i=0;i<coroutine->stacksize/4;i++) {
+        coroutine->stack[i] = COROUTINE_STACKFILL;
+    }
+
+    /* r4 holds the coroutine, lr the entry; the rest is 0 */
+    sp = coroutine->stack + coroutine->stacksize/4 - COROUTINE_FRAMEWORDS;
+    sp[0] = (unsigned int)coroutine;
+    for(i=1;i<COROUTINE_FRAMEWORDS-1;i++) {
+        sp[i] = 0;
+    }
+    sp[COROUTINE_FRAMEWORDS-1] = (unsigned int)__coroutine_entry;
+
+    coroutine->sp = sp;
+    coroutine->function = function;
+    coroutine->arg = arg;
+    coroutine->running = TRUE;
+
+    return GOOD;
+}
+
+error_t coroutine_resume(coroutine_t *coroutine)
+/*!
+  Continue 'coroutine' until it yields or returns. Returns BUSY when it yielded, GOOD
+  when it has returned, and INVALID when it wasn't running (so wasn't started, or had
+  returned already) or is running now (it's the one calling this, or resumed it)
+*/
+{
+    coroutine_t *active;
+
+    if(!coroutine->running) {
+        return INVALID;
+    }
+    for(active=coroutine_running;active!=NULL;active=active->caller) {
+        if(active == coroutine) {
+            return INVALID;
+        }
+    }
+
+    coroutine->caller = coroutine_running;
+    coroutine_running = coroutine;
+    __coroutine_swap(&coroutine->callersp, coroutine->sp);
+    coroutine_running = coroutine->caller;
+    coroutine->caller = NULL;
+
+    if(coroutine->running) {
+        return BUSY;
+    }
+    return GOOD;
+}
+
+void coroutine_yield(void)
+/*!
+  Stop the running coroutine; coroutine_resume() returns in the one that resumed it. The
+  next coroutine_resume() continues from here. Does nothing outside a coroutine
+*/
+{
+    coroutine_t *coroutine = coroutine_running;
+
+    if(coroutine != NULL) {
+        __coroutine_swap(&coroutine->sp, coroutine->callersp);
+    }
+}
+
+coroutine_t *coroutine_current(void)
+/*!
+  Return the running coroutine, or NULL outside a coroutine
+*/
+{
+    return coroutine_running;
+}
+
+unsigned int coroutine_stackunused(const coroutine_t *coroutine)
+/*!
+  Return the amount of bytes of the coroutine's stack that were never used
+*/
+{
+    unsigned int i;
+
+    for(i=0;i<coroutine->stacksize/4;i++) {
+        if(coroutine->stack[i] != COROUTINE_STACKFILL) {
+            break;
+        }
+    }
+    return i*4;
+}
+
+void __coroutine_main(coroutine_t *coroutine)
+/*
+  Runs the coroutine function, on the coroutine's stack. When it returns, back to the
+  one that resumed it, for the last time
+*/
+{
+    coroutine->function(coroutine->arg);
+
+    coroutine->running = FALSE;
+    __coroutine_swap(&coroutine->sp, coroutine->callersp);
+
+    /* Can't be resumed anymore */
+    for(;;);
+}
@@ -0,0 +1,93 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    debug.c:
+            Per-module runtime debug levels
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -The actual output is done by the macro's in debug.h; this file only keeps
+             track of the runtime level of each debug module.
+
+*/
+/*!
+\file
+Per-module runtime debug levels
+*/
+#include <debug.h>
+#include <err.h>
+
+#if DEBUG
+
+/* Every module starts with the default level from config.h */
+unsigned char debug_levels[DMOD_COUNT] = { [0 ... DMOD_COUNT-1] = DEBUG_DEFAULTLEVEL };
+
+/* Names of the ALDS modules, as shown by debug_printlevels() */
+static const char * const debug_modulenames[DMOD_USER] = {
+    "system", "ringbuffer", "uart", "adc", "timer", "vic", "pll", "i2c", "spi", "iap"
+};
+
+error_t debug_setlevel(const unsigned char module, const unsigned char level)
+/*!
+  Set the runtime debug level of the given module. Note that messages above the
+  DEBUG level set in config.h are not compiled in, so setting a level above that
+  won't give any more output.
+*/
+{
+    if(module >= DMOD_COUNT || level > D_XINFO) {
+        return INVALID;
+    }
+    debug_levels[module] = level;
+
+    return GOOD;
+}
+
+unsigned char debug_getlevel(const unsigned char module)
+/*!
+  Return the runtime debug level of the given module
+*/
+{
+    if(module >= DMOD_COUNT) {
+        return D_NONE;
+    }
+    return debug_levels[module];
+}
+
+void debug_setlevels(const unsigned char level)
+/*!
+  Set the runtime debug level of all modules at once
+*/
+{
+    unsigned char module;
+
+    for(module=0;module<DMOD_COUNT;module++) {
+        debug_levels[module] = level;
+    }
+}
+
+void debug_printlevels(void)
+/*!
+  Print the runtime debug level of all modules on the debug console
+*/
+{
+    unsigned char module;
+
+    dprint("module\t\tlevel (compiled in: %i)\n\r", DEBUG);
+    for(module=0;module<DMOD_COUNT;module++) {
+        if(module < DMOD_USER) {
+            dprint("%i %s\t%i\n\r", module, debug_modulenames[module], debug_levels[module]);
+        }
+        else {
+            dprint("%i user%i\t\t%i\n\r", module, module-DMOD_USER, debug_levels[module]);
+        }
+    }
+}
+
+#endif /* DEBUG */
@@ -0,0 +1,199 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    defer_ARM.c:
+                Deferred work queue
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Always compiled in ARM mode, as defer_post() reads the CPSR.
+            -Each queue has one reader (defer_run() or the software interrupt) which only
+             changes readpos, and writers which only change writepos. The positions are free
+             running 8 bit counters, so the amount of items waiting is writepos - readpos.
+            -Writers don't disturb each other as long as they're not interrupted by another
+             writer. An IRQ handler (without IRQ_NESTED) runs with IRQ disabled, so it can post
+             without touching the interrupt status; everywhere else IRQ is disabled for the
+             few instructions it takes. The ARM7 has no exclusive load/store to do without.
+
+*/
+/*!
+\file
+Deferred work queue
+*/
+#include <config.h>
+#include <defer.h>
+#include <initcall.h>
+#include <irq.h>
+#include <vic.h>
+#include <err.h>
+#include <gcc.h>
+#include "registers.h"
+
+#if DEFER_SOFTINT && KERNEL && PRIO_DEFER == PRIO_KERNEL
+#error "PRIO_DEFER and PRIO_KERNEL share a VIC slot; move one of them (see vic.h)"
+#endif
+
+#if DEFER_QUEUELENGTH & (DEFER_QUEUELENGTH - 1)
+#error "DEFER_QUEUELENGTH must be a power of 2"
+#endif
+#if DEFER_QUEUELENGTH > 128 || DEFER_QUEUELENGTH < 1
+#error "DEFER_QUEUELENGTH must be between 1 and 128"
+#endif
+
+typedef struct deferqueue {
+    deferwork_t work[DEFER_QUEUELENGTH];
+    volatile unsigned char writepos;    /* Next position to write */
+    volatile unsigned char readpos;     /* Next position to read */
+} deferqueue_t;
+
+static deferqueue_t deferqueue[DEFER_PRIORITIES];
+
+#if DEFER_SOFTINT
+static IRQFUNC unsigned int defer_process(void);
+static IRQFUNC void defer_intHandler(void);
+
+error_t defer_init(void)
+/*!
+  Install the software interrupt that does the deferred work. This is an initcall,
+  so init() takes care of it
+*/
+{
+    VICSoftIntClear = (1<<DEFER_SOFTINT);
+    vic_setup(DEFER_SOFTINT, IRQ, PRIO_DEFER, defer_intHandler);
+
+    return GOOD;
+}
+INITCALL(INITCALL_DRIVER, defer_init);
+#else
+static unsigned int defer_process(void);
+#endif
+
+error_t defer_post(const unsigned char priority, const DEFERFUNCTION function, void *arg)
+/*!
+  Queue a call to 'function' with argument 'arg', at the given priority (one of the
+  DEFER_* defines). Returns OVERFLOW when the queue for that priority is full, and
+  INVALID when the priority doesn't exist.
+  May be called from IRQ handlers, not from the FIQ handler.
+*/
+{
+    deferqueue_t *queue;
+    deferwork_t *work;
+    unsigned int cpsr;
+    interrupt_t status = 0;
+    error_t result = GOOD;
+
+    if(priority >= DEFER_PRIORITIES) {
+        return INVALID;
+    }
+    queue = &deferqueue[priority];
+
+    /* When IRQ is disabled already, nothing can get in between */
+    asm volatile ("mrs     %0, cpsr" : "=r" (cpsr));
+    if(!(cpsr & IRQ)) {
+        __critical_enter_irq(status);
+    }
+
+    if((unsigned char)(queue->writepos - queue->readpos) >= DEFER_QUEUELENGTH) {
+        result = OVERFLOW;
+    }
+    else {
+        work = &queue->work[queue->writepos & (DEFER_QUEUELENGTH-1)];
+        work->function = function;
+        work->arg = arg;
+        /* The item must be complete before the reader can see it */
+        barrier();
+        queue->writepos++;
+        #if DEFER_SOFTINT
+        VICSoftInt = (1<<DEFER_SOFTINT);
+        #endif
+    }
+
+    if(!(cpsr & IRQ)) {
+        __critical_exit(status);
+    }
+
+    return result;
+}
+
+static unsigned int defer_process(void)
+/*
+  Do all queued work, highest priority first. Returns the amount of items done
+*/
+{
+    deferqueue_t *queue;
+    deferwork_t work;
+    unsigned char priority;
+    unsigned int count = 0;
+
+    priority = DEFER_HIGH;
+    while(priority < DEFER_PRIORITIES) {
+        queue = &deferqueue[priority];
+        if(queue->readpos == queue->writepos) {
+            /* Nothing (left) on this priority */
+            priority++;
+            continue;
+        }
+        barrier();
+        work = queue->work[queue->readpos & (DEFER_QUEUELENGTH-1)];
+        barrier();
+        queue->readpos++;
+
+        work.function(work.arg);
+        count++;
+
+        /* Higher priority work may have been posted meanwhile */
+        priority = DEFER_HIGH;
+    }
+
+    return count;
+}
+
+#if DEFER_SOFTINT
+static void defer_intHandler(void)
+/*
+  Software interrupt, does the deferred work with IRQ's enabled
+*/
+{
+    /* Cleared before the work is done; work posted from here on triggers it again */
+    VICSoftIntClear = (1<<DEFER_SOFTINT);
+
+    #if !IRQ_NESTED
+    __enable_nested_interrupts();
+    #endif
+    defer_process();
+    #if !IRQ_NESTED
+    __disable_nested_interrupts();
+    #endif
+}
+#else
+unsigned int defer_run(void)
+/*!
+  Do all queued work, highest priority first. Call this from the main loop. Returns
+  the amount of items done
+*/
+{
+    return defer_process();
+}
+#endif /* DEFER_SOFTINT */
+
+bool defer_pending(void)
+/*!
+  Returns TRUE when there's work waiting
+*/
+{
+    unsigned char priority;
+
+    for(priority=DEFER_HIGH;priority<DEFER_PRIORITIES;priority++) {
+        if(deferqueue[priority].readpos != deferqueue[priority].writepos) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
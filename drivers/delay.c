@@ -13,7 +13,16 @@
               version 2 of the License, or (at your option) any later version.
 
     remarks:
-            -These are simple and small delay functions. The do not use any special hardware and can
+            -With TIMEBASE enabled (see config.h), the delays are timed with the system time
+             (timebase.h). They're never shorter than requested, at any clock setting, and
+             delays of 10us or more are spent in idle mode (with SLEEPWHENWAITING); shorter ones
+             are a busy loop. Interrupts that come in meanwhile make them longer, by no more
+             than the time their handlers take.
+            -The system time can't be used before time_init() ran, with IRQ disabled, or from
+             an interrupt handler (see time_canwait()); the delays then fall back to the
+             calibrated busy loops below. So they still work from such places, like dac_put()
+             and uart1_putchar_timeout() may be called from.
+            -Without it, these are simple and small delay functions. The do not use any special hardware and can
              be used everywhere, at any time. This ofcourse has it's price; they are not that precise..
              Especially the delay_us() function is not too good at this..
              Note: timings will never be shorter than requested; longer on the other hand is very well
@@ -26,6 +35,52 @@ Simple delay functions
 */
 #include <delay.h>
 
+#if TIMEBASE
+#include <timebase.h>
+
+/* One tick extra, as the current tick has partly passed already */
+#define delay_ticks(ticks)  time_waituntil(time_now_ticks() + (ticks) + 1)
+
+void delay_us(const unsigned int time)
+/*!
+  Delay for 'time' microseconds
+*/
+{
+    if(time_canwait()) {
+        delay_ticks(time_us_to_ticks(time));
+    }
+    else {
+        delay(time, DELAY_US);
+    }
+}
+
+void delay_ms(const unsigned int time)
+/*!
+  Delay for 'time' milliseconds
+*/
+{
+    if(time_canwait()) {
+        delay_ticks(time_ms_to_ticks(time));
+    }
+    else {
+        delay(time, DELAY_MS);
+    }
+}
+
+void delay_s(const unsigned int time)
+/*!
+  Delay for 'time' seconds
+*/
+{
+    if(time_canwait()) {
+        delay_ticks(time_ms_to_ticks(time) * 1000);
+    }
+    else {
+        delay(time, DELAY_S);
+    }
+}
+#endif /* TIMEBASE */
+
 void delay(volatile unsigned int time, volatile const unsigned int unit)
 /*!
   Delay for some time
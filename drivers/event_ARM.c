@@ -0,0 +1,209 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    event_ARM.c:
+                Event loop
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Always compiled in ARM mode, so the critical sections are inline and event_post()
+             doesn't call anything outside RAM with IRQ_IN_RAM.
+            -Pending events are bits in one word; event_run() takes all of them at once, and
+             finds them with lowestbit() (see std.h).
+            -Before going idle, event_run() checks for work with IRQ disabled. An IRQ that
+             comes in after the check still wakes the CPU (the VIC wakes it, whatever the I
+             bit), and it's handler runs as soon as IRQ is enabled again. So no event is
+             left waiting for the next IRQ.
+            -The idle statistics assume event_run() is called at least once every timer
+             wrap (about a minute at 60MHz PCLK).
+
+*/
+/*!
+\file
+Event loop
+*/
+#include <config.h>
+#include <event.h>
+#include <defer.h>
+#include <initcall.h>
+#include <irq.h>
+#include <power.h>
+#include <std.h>
+#include <err.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if EVENT_IDLESTATS
+#if EVENT_TIMER != 0 && EVENT_TIMER != 1
+#error "EVENT_TIMER must be 0 or 1"
+#endif
+#if (TIMEBASE && TIMEBASE_TIMER == EVENT_TIMER) || (CAPTURE && CAPTURE_TIMER == EVENT_TIMER) || \
+    (KERNEL && KERNEL_TIMER == EVENT_TIMER) || (SWTIMER && SWTIMER_TIMER == EVENT_TIMER) || \
+    (WAVEFORM && WAVEFORM_TIMER == EVENT_TIMER) || (TIMERPWM && TIMERPWM_TIMER == EVENT_TIMER)
+#error "The idle statistics need a timer of their own (see EVENT_TIMER)"
+#endif
+
+#define __EVENT_REG(timer, reg)     T##timer##reg
+#define EVENT_REG(timer, reg)       __EVENT_REG(timer, reg)
+#define EVENT_TCR                   EVENT_REG(EVENT_TIMER, TCR)
+#define EVENT_TC                    EVENT_REG(EVENT_TIMER, TC)
+#define EVENT_PR                    EVENT_REG(EVENT_TIMER, PR)
+
+/* Time spent idle and in total since the last event_idlepercent(), and when the
+   total was last updated */
+static unsigned long long event_idle;
+static unsigned long long event_total;
+static unsigned int event_last;
+#endif /* EVENT_IDLESTATS */
+
+static EVENTFUNCTION event_handlers[EVENTS];
+static volatile unsigned int event_pending;
+
+error_t event_register(const unsigned char event, const EVENTFUNCTION handler)
+/*!
+  Have 'handler' called by event_run() when 'event' (0 to EVENTS-1) is posted. Use NULL
+  to remove it. Returns INVALID when the event doesn't exist
+*/
+{
+    if(event >= EVENTS) {
+        return INVALID;
+    }
+    event_handlers[event] = handler;
+
+    return GOOD;
+}
+
+error_t event_post(const unsigned char event)
+/*!
+  Post 'event'; it's handler is called from event_run(). May be called from IRQ handlers,
+  not from the FIQ handler. Returns INVALID when the event doesn't exist
+*/
+{
+    interrupt_t status;
+
+    if(event >= EVENTS) {
+        return INVALID;
+    }
+
+    __critical_enter_irq(status);
+    event_pending |= (1<<event);
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+void event_run(void)
+/*!
+  Call the handlers of all posted events, and do the deferred work (with DEFER_SOFTINT 0).
+  When there's nothing to do, wait in idle mode for an interrupt (with SLEEPWHENWAITING).
+  Call this from the main loop, or use event_loop()
+*/
+{
+    interrupt_t status;
+    unsigned int pending;
+    unsigned char event;
+    #if EVENT_IDLESTATS
+    unsigned int now;
+    #endif
+
+    __critical_enter_irq(status);
+    pending = event_pending;
+    event_pending = 0;
+    __critical_exit(status);
+
+    #if !DEFER_SOFTINT
+    if(pending == 0 && defer_run() != 0) {
+        /* Did some work */
+        pending = 1;
+    }
+    #endif
+
+    if(pending == 0) {
+        /* Nothing to do. Make sure nothing was posted meanwhile, and wait */
+        __critical_enter_irq(status);
+        #if EVENT_IDLESTATS
+        now = EVENT_TC;
+        #endif
+        if(event_pending == 0 && !defer_pending()) {
+            #if SLEEPWHENWAITING
+            cpu_poweridle();
+            #endif
+        }
+        #if EVENT_IDLESTATS
+        event_idle += EVENT_TC - now;
+        #endif
+        __critical_exit(status);
+    }
+    else {
+        while(pending) {
+            event = lowestbit(pending);
+            if(event_handlers[event] != NULL) {
+                event_handlers[event](event);
+            }
+            /* Clear the lowest bit */
+            pending &= pending - 1;
+        }
+        #if !DEFER_SOFTINT
+        defer_run();
+        #endif
+    }
+
+    #if EVENT_IDLESTATS
+    now = EVENT_TC;
+    event_total += now - event_last;
+    event_last = now;
+    #endif
+}
+
+void event_loop(void)
+/*!
+  Run the event loop forever
+*/
+{
+    for(;;) {
+        event_run();
+    }
+}
+
+#if EVENT_IDLESTATS
+error_t event_startstats(void)
+/*!
+  Start the EVENT_TIMER, if it isn't running already. This is an initcall,
+  so init() takes care of it
+*/
+{
+    if(!(EVENT_TCR & BIT_TCR_ENABLE)) {
+        EVENT_TCR = BIT_TCR_RESET;
+        EVENT_PR = 0;
+        EVENT_TCR = BIT_TCR_ENABLE;
+    }
+    event_last = EVENT_TC;
+
+    return GOOD;
+}
+INITCALL(INITCALL_BOARD, event_startstats);
+
+unsigned char event_idlepercent(void)
+/*!
+  Return the percentage of time event_run() spent idle since the previous call
+  (or since startup)
+*/
+{
+    unsigned char percent = 0;
+
+    if(event_total != 0) {
+        percent = (unsigned char)((event_idle * 100) / event_total);
+    }
+    event_idle = 0;
+    event_total = 0;
+
+    return percent;
+}
+#endif /* EVENT_IDLESTATS */
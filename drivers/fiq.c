@@ -0,0 +1,72 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    fiq.c:
+          FIQ fast path
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -See fiq.h for how to use this. The FIQ entry itself is found in crt0.S, the
+             functions to access the banked registers in fiq_ARM.S
+
+*/
+/*!
+\file
+FIQ fast path
+*/
+#include <config.h>
+
+#if FIQ_HANDLER
+#include <fiq.h>
+#include <vic.h>
+#include <irq.h>
+#include "exceptions.h"
+#include "registers.h"
+
+#if FIQ_HANDLER == 1
+/* The C handler, called from FIQHandler in crt0.S */
+FIQFUNCTION fiq_handler = (FIQFUNCTION)__HaltFiq;
+#endif
+
+void fiq_init(const unsigned char channel, const FIQFUNCTION handler)
+/*!
+  Handle the given VIC channel (one of the VIC_CH_* defines) as FIQ, and enable
+  FIQ's. There can be only one FIQ source; any other channel that was set up as
+  FIQ is disabled.
+  With FIQ_HANDLER 1, 'handler' is the C function to call. With FIQ_HANDLER 2
+  it's ignored, and should be NULL; fiq_asmhandler() is used instead.
+  When the handler keeps it's state in the banked registers, load them with
+  fiq_setregisters() before calling this.
+*/
+{
+    __disable_interrupts(FIQ);
+
+    /* Disable the current FIQ source (if any), and hand it back to the IRQ side */
+    VICIntEnClr = VICIntSelect;
+    VICIntSelect = 0;
+
+    #if FIQ_HANDLER == 1
+    fiq_handler = handler;
+    #endif
+    vic_setup(channel, FIQ, 0, NULL);
+
+    __enable_interrupts(FIQ);
+}
+
+void fiq_stop(void)
+/*!
+  Disable the FIQ source. This may be called from the FIQ handler itself, when
+  it's done (the buffer is full, for example). Call fiq_init() to start again
+*/
+{
+    VICIntEnClr = VICIntSelect;
+}
+
+#endif /* FIQ_HANDLER */
@@ -14,6 +14,9 @@
 
     remarks:
             -This wraps the whole thing together, and should be the first thing to call from main()
+            -The basic system (PLL, VIC, debug console, I/O and watchdog) is brought up by
+             INITCALL_CORE initcalls, which init() calls in a fixed order. After that, the
+             other initcalls (see initcall.h) are run, level by level.
 
 */
 /*!
@@ -28,6 +31,7 @@ ALDS initialization code
 #include <watchdog.h>
 #include <io.h>
 #include <debug.h>
+#include <initcall.h>
 #include "exceptions.h"
 
 static char resetcause;
@@ -38,20 +42,99 @@ static char resetcause;
 const unsigned int codeprotection __attribute__ ((section(".codeprotection"))) = 0x87654321;
 #endif
 
+static error_t init_pll(void)
+/*
+  Initialize the PLL and MAM; after this we're running at the speed set in config.h
+*/
+{
+    pll_init();
+    /* Keep the initcall timestamps in microseconds */
+    initcall_clockchanged();
+
+    return GOOD;
+}
+INITCALL(INITCALL_CORE, init_pll);
+
+static error_t init_vic(void)
+/*
+  Initialize the VIC
+*/
+{
+    vic_init(NULL);
+
+    return GOOD;
+}
+INITCALL(INITCALL_CORE, init_vic);
+
+#if DEBUG
+static error_t init_debug(void)
+/*
+  Start the debug-system. After this the basic system is online, and failing
+  initcalls are reported
+*/
+{
+    debug_init();
+
+    return GOOD;
+}
+INITCALL(INITCALL_CORE, init_debug);
+#endif
+
+static error_t init_io(void)
+/*
+  Configure I/O; this enables fast I/O if that's supported
+*/
+{
+    io_init();
+
+    return GOOD;
+}
+INITCALL(INITCALL_CORE, init_io);
+
+static error_t init_watchdog(void)
+/*
+  Set-up the watchdog, with an interval of tPCLK x interval x 4, and find out
+  why we booted
+*/
+{
+    extern unsigned int powerloss;
+
+    /* When this function returns TRUE, the current boot was initiated by a watchdog timeout. */
+    if(watchdog_init(WATCHDOG_TIMEOUT)) {
+        resetcause = RESET_WATCHDOG;
+    }
+    else {
+        #if POWERLOSSDETECTION
+        if(powerloss != 0x55AA55AA) {
+            powerloss = 0x55AA55AA;
+            resetcause = RESET_POWERUP;
+        }
+        else {
+            resetcause = RESET_SOFT;
+        }
+        #else
+        resetcause = RESET_POWERUP;
+        #endif
+    }
+
+    return GOOD;
+}
+INITCALL(INITCALL_CORE, init_watchdog);
+
 error_t init(bool enableirq)
 /*!
   Initialize the system.
-  When you want to add your own code to this, make sure you add it after the
-  debug_init() line; that way the debug-system will be active so any possible
-  crashes can be identified.
+  When you want to add your own code to this, register it as an initcall (see
+  initcall.h); those run after the basic system is up, so the debug-system will be
+  active and any possible crashes can be identified.
+  When 'enableirq' is FALSE, INITCALL_LATE initcalls are not run; call
+  initcall_run(INITCALL_LATE, INITCALL_LATE) after enabling interrupts yourself.
 */
 {
-    extern unsigned int powerloss;
-
     #if STACKCANARY != 0
     unsigned int *p;
 
-    #if STACKSIZE_FIQ > 4
+    #if STACKSIZE_FIQ > 4 || FIQ_HANDLER == 1
     /* Last byte of FIQ stack */
     extern unsigned int __stack_start_irq__;
     p = &__stack_start_irq__-1;
@@ -83,45 +166,32 @@ error_t init(bool enableirq)
     *p = STACKCANARY;
     #endif
 
+    /* Start the clock for the initcall timestamps */
+    initcall_starttimer();
+
     /* Clear the error-flag */
     err = GOOD;
-    /* Initialize the PLL and MAM; after this we're running at the speed set in config.h */
-    pll_init();
-    /* Initialize the VIC */
-    vic_init(NULL);
-    /* Start the debug-system. After this the basic system is online;
-       add any custom initialization-code after these calls */
+    /* Bring up the basic system, step by step. These are initcalls as well, so
+       initcall_report() shows how long each took */
+    initcall_call(&__initcall_init_pll);
+    initcall_call(&__initcall_init_vic);
     #if DEBUG
-    debug_init();
+    initcall_call(&__initcall_init_debug);
     #endif
+    initcall_call(&__initcall_init_io);
+    initcall_call(&__initcall_init_watchdog);
 
-    /* Configure I/O; this enables fast I/O if that's supported */
-    io_init();
-
-    /* Set-up the watchdog, with an interval of tPCLK x interval x 4.
-       When this function returns TRUE, the current boot was initiated by a watchdog timeout. */
-    if(watchdog_init(WATCHDOG_TIMEOUT)) {
-        resetcause = RESET_WATCHDOG;
-    }
-    else {
-        #if POWERLOSSDETECTION
-        if(powerloss != 0x55AA55AA) {
-            powerloss = 0x55AA55AA;
-            resetcause = RESET_POWERUP;
-        }
-        else {
-            resetcause = RESET_SOFT;
-        }
-        #else
-        resetcause = RESET_POWERUP;
-        #endif
-    }
+    /* Run the initcalls registered by drivers and project code */
+    initcall_run(INITCALL_BOARD, INITCALL_APP);
 
     if(enableirq) {
         /* OK, enable interrupts (IRQ only, FIQ stays off). This is really the most
            tricky part; faulty interrupt-settings will cause the system to crash
            after this point.. */
         __enable_interrupts(IRQ);
+
+        /* And the initcalls that need interrupts */
+        initcall_run(INITCALL_LATE, INITCALL_LATE);
     }
 
     /* OK, we're good to go */
@@ -136,8 +206,8 @@ void stack_canary_check()
 {
     unsigned int *p;
 
-#if STACKSIZE_FIQ > 4
-    /* FIQ, only checked when enabled */
+#if STACKSIZE_FIQ > 4 || FIQ_HANDLER == 1
+    /* FIQ, only checked when used */
     extern unsigned int __stack_start_irq__;
     p = &__stack_start_irq__-1;
     if(*p != STACKCANARY) {
@@ -0,0 +1,191 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    initcall.c:
+               Initcall table
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Initcalls are registered with INITCALL() or LAZYINITCALL() (see initcall.h). Each
+             of these puts an entry in a '.initcall.<level>' section; the Linkerscript
+             collects these, sorted by level, into one table between __initcall_beg__ and
+             __initcall_end__. The lazy ones are at the end, starting at __initcall_lazy__.
+            -When INITCALL_TIMING is set (see config-debug.h), every initcall gets a start
+             timestamp and duration, taken from the timer selected by INITCALL_TIMER. These
+             are counted from the start of init(), in microseconds. The timer is prescaled
+             to the clock that's actually running, and again after pll_init() changed it
+             (initcall_clockchanged()), so the core steps before that are timed as well.
+
+*/
+/*!
+\file
+Initcall table
+*/
+#include <initcall.h>
+#include <debug.h>
+#include <err.h>
+#include <pll.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+/* Set by the Linkerscript */
+extern const initcall_t __initcall_beg__[];
+extern const initcall_t __initcall_lazy__[];
+extern const initcall_t __initcall_end__[];
+
+#if INITCALL_TIMING
+#if INITCALL_TIMER != 0 && INITCALL_TIMER != 1
+#error "INITCALL_TIMER must be 0 or 1"
+#endif
+#if (TIMEBASE && TIMEBASE_TIMER == INITCALL_TIMER) || (CAPTURE && CAPTURE_TIMER == INITCALL_TIMER) || \
+    (KERNEL && KERNEL_TIMER == INITCALL_TIMER) || (SWTIMER && SWTIMER_TIMER == INITCALL_TIMER) || \
+    (WAVEFORM && WAVEFORM_TIMER == INITCALL_TIMER) || (TIMERPWM && TIMERPWM_TIMER == INITCALL_TIMER)
+#error "The initcall timestamps need a timer of their own (see INITCALL_TIMER)"
+#endif
+
+#define __INITCALL_REG(timer, reg)  T##timer##reg
+#define INITCALL_REG(timer, reg)    __INITCALL_REG(timer, reg)
+#define INITCALL_TCR                INITCALL_REG(INITCALL_TIMER, TCR)
+#define INITCALL_TC                 INITCALL_REG(INITCALL_TIMER, TC)
+#define INITCALL_PR                 INITCALL_REG(INITCALL_TIMER, PR)
+#define INITCALL_PC                 INITCALL_REG(INITCALL_TIMER, PC)
+
+/* Timer value when the last initcall_run() finished */
+static unsigned int initcall_boottime;
+
+static void initcall_setprescaler(void)
+/*
+  Have the timer count microseconds at the current peripheral clock (or as close as
+  it gets, below 1MHz)
+*/
+{
+    unsigned int ticks = pll_pclk()/1000000;
+
+    INITCALL_PR = ticks ? ticks-1 : 0;
+}
+
+void initcall_starttimer(void)
+/*!
+  (Re)start the timer used for the initcall timestamps, counting microseconds at
+  the clock that's running now. Called by init()
+*/
+{
+    INITCALL_TCR = BIT_TCR_RESET;
+    initcall_setprescaler();
+    INITCALL_TCR = BIT_TCR_ENABLE;
+}
+
+void initcall_clockchanged(void)
+/*!
+  The peripheral clock changed; keep the timer counting microseconds. Called by
+  init() after pll_init()
+*/
+{
+    initcall_setprescaler();
+    /* The prescale counter may be past the new limit already */
+    INITCALL_PC = 0;
+}
+#else
+void initcall_starttimer(void)
+/*!
+  Initcall timing is disabled, nothing to do
+*/
+{
+}
+
+void initcall_clockchanged(void)
+/*!
+  Initcall timing is disabled, nothing to do
+*/
+{
+}
+#endif /* INITCALL_TIMING */
+
+error_t initcall_call(const initcall_t *initcall)
+/*!
+  Call a single initcall, and record it's result (and timing). Returns the result
+*/
+{
+    initcallstate_t *state = initcall->state;
+
+    #if INITCALL_TIMING
+    state->start = INITCALL_TC;
+    state->result = initcall->function();
+    state->duration = INITCALL_TC - state->start;
+    #else
+    state->result = initcall->function();
+    #endif
+
+    if(state->result != GOOD) {
+        derror(DMOD_SYSTEM, "initcall %s failed (%i)\n\r", initcall->name, state->result);
+    }
+
+    return state->result;
+}
+
+void initcall_run(const unsigned char from, const unsigned char to)
+/*!
+  Run all initcalls with a level from 'from' up to and including 'to' that did
+  not run successfully yet. Lazy initcalls are never run from here.
+*/
+{
+    const initcall_t *initcall;
+
+    for(initcall=__initcall_beg__; initcall<__initcall_lazy__; initcall++) {
+        if(initcall->level >= from && initcall->level <= to && initcall->state->result != GOOD) {
+            initcall_call(initcall);
+        }
+    }
+
+    #if INITCALL_TIMING
+    initcall_boottime = INITCALL_TC;
+    #endif
+}
+
+#if DEBUG
+void initcall_report(void)
+/*!
+  Print all initcalls, their result and (when INITCALL_TIMING is enabled) when
+  they ran and how long it took, on the debug console
+*/
+{
+    const initcall_t *initcall;
+
+    dprint("level\tresult\t");
+    #if INITCALL_TIMING
+    dprint("start\ttime (us)\t");
+    #endif
+    dprint("name\n\r");
+
+    for(initcall=__initcall_beg__; initcall<__initcall_end__; initcall++) {
+        dprint("%i\t%i\t", initcall->level, initcall->state->result);
+        #if INITCALL_TIMING
+        if(initcall->state->result != INITCALL_NOTRUN) {
+            dprint("%i\t%i\t\t", initcall->state->start, initcall->state->duration);
+        }
+        else {
+            dprint("-\t-\t\t");
+        }
+        #endif
+        dprint("%s\n\r", initcall->name);
+    }
+
+    #if INITCALL_TIMING
+    dprint("boot took %i us\n\r", initcall_boottime);
+    #endif
+}
+#else
+void initcall_report(void)
+/*!
+  No debug console, nothing to report
+*/
+{
+}
+#endif /* DEBUG */
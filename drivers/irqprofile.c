@@ -0,0 +1,245 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    irqprofile.c:
+                 Per VIC channel IRQ profiler
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -With IRQPROFILE enabled (see config.h), IRQHandler in crt0.S reads the timer
+             right after the IRQ exception, and calls irqprofile_dispatch() with the handler
+             address from the VIC. That calls the handler, and updates the administration.
+            -The administration is done after the handler has finished, so it's not part of
+             the measured duration. It does add to the time the next IRQ has to wait.
+
+*/
+/*!
+\file
+Per VIC channel IRQ profiler
+*/
+#include <config.h>
+
+#if IRQPROFILE
+#include <irqprofile.h>
+#include <initcall.h>
+#include <irq.h>
+#include <vic.h>
+#include <debug.h>
+#include <err.h>
+#include <std_string.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if IRQPROFILE_TIMER != 0 && IRQPROFILE_TIMER != 1
+#error "IRQPROFILE_TIMER must be 0 or 1"
+#endif
+#if (TIMEBASE && TIMEBASE_TIMER == IRQPROFILE_TIMER) || (CAPTURE && CAPTURE_TIMER == IRQPROFILE_TIMER) || \
+    (KERNEL && KERNEL_TIMER == IRQPROFILE_TIMER) || (SWTIMER && SWTIMER_TIMER == IRQPROFILE_TIMER) || \
+    (WAVEFORM && WAVEFORM_TIMER == IRQPROFILE_TIMER) || (TIMERPWM && TIMERPWM_TIMER == IRQPROFILE_TIMER)
+#error "The IRQ profiler needs a timer of it's own (see IRQPROFILE_TIMER)"
+#endif
+
+#define __IRQPROFILE_REG(timer, reg)    T##timer##reg
+#define IRQPROFILE_REG(timer, reg)      __IRQPROFILE_REG(timer, reg)
+#define IRQPROFILE_TCR                  IRQPROFILE_REG(IRQPROFILE_TIMER, TCR)
+#define IRQPROFILE_TC                   IRQPROFILE_REG(IRQPROFILE_TIMER, TC)
+#define IRQPROFILE_PR                   IRQPROFILE_REG(IRQPROFILE_TIMER, PR)
+
+/* One for each channel, and one for IRQPROFILE_UNKNOWN */
+static irqprofile_t irqprofile[IRQPROFILE_CHANNELS+1];
+/* Channels that were seen waiting at the end of a handler, and when that handler started */
+static unsigned int irqprofile_waiting;
+static unsigned int irqprofile_waitingsince[IRQPROFILE_CHANNELS];
+
+static IRQFUNC unsigned char irqprofile_channel(const FUNCTION handler, unsigned int pending);
+
+error_t irqprofile_start(void)
+/*!
+  Start the IRQPROFILE_TIMER, if it isn't running already. This is an initcall,
+  so init() takes care of it
+*/
+{
+    if(!(IRQPROFILE_TCR & BIT_TCR_ENABLE)) {
+        IRQPROFILE_TCR = BIT_TCR_RESET;
+        IRQPROFILE_PR = 0;
+        IRQPROFILE_TCR = BIT_TCR_ENABLE;
+    }
+
+    return GOOD;
+}
+INITCALL(INITCALL_BOARD, irqprofile_start);
+
+static unsigned char irqprofile_channel(const FUNCTION handler, unsigned int pending)
+/*
+  Find the VIC channel handled by 'handler'. 'pending' is VICIRQStatus from
+  before the handler was called, used for non-vectored IRQ's
+*/
+{
+    unsigned char slot;
+    unsigned char channel;
+    unsigned int address;
+
+    for(slot=PRIO_MAX;slot<=PRIO_MIN;slot++) {
+        if(VICVectCntlArray[slot] & SLOT_ENABLED) {
+            channel = VICVectCntlArray[slot] & 0x1F;
+            address = VICVectAddrArray[slot];
+            #if IRQ_DIRECT
+            if(address == __irq_slots[slot]) {
+                /* A stub, get the handler it calls */
+                address = (unsigned int)__vic_handlers[slot];
+            }
+            #endif
+            if(address == (unsigned int)handler) {
+                return channel;
+            }
+            /* A vectored channel can't be the non-vectored IRQ */
+            pending &= ~(1<<channel);
+        }
+    }
+
+    /* Non-vectored */
+    for(channel=0;channel<IRQPROFILE_CHANNELS;channel++) {
+        if(pending & (1<<channel)) {
+            return channel;
+        }
+    }
+
+    return IRQPROFILE_UNKNOWN;
+}
+
+void irqprofile_dispatch(const FUNCTION handler, const unsigned int entry)
+/*!
+  Called by IRQHandler (crt0.S) instead of the IRQ handler. Calls 'handler', and
+  measures it. 'entry' is the timer value at the IRQ exception
+*/
+{
+    unsigned int pending = VICIRQStatus;
+    unsigned int start, duration, latency, waiting;
+    unsigned char channel;
+    irqprofile_t *profile;
+    #if IRQ_NESTED
+    interrupt_t status;
+    #endif
+
+    start = IRQPROFILE_TC;
+    handler();
+    duration = IRQPROFILE_TC - start;
+
+    channel = irqprofile_channel(handler, pending);
+
+    #if IRQ_NESTED
+    /* Handlers (and this function) are called with IRQ enabled, so keep nested
+       IRQ's out while the administration is updated */
+    __critical_enter_irq(status);
+    #endif
+
+    latency = start - entry;
+    if(channel < IRQPROFILE_CHANNELS) {
+        if(irqprofile_waiting & (1<<channel)) {
+            /* Was already waiting at the end of an earlier handler */
+            latency = start - irqprofile_waitingsince[channel];
+        }
+        pending &= ~(1<<channel);
+    }
+    /* Forget channels that are no longer waiting */
+    irqprofile_waiting &= pending;
+
+    profile = &irqprofile[channel];
+    profile->count++;
+    profile->total += duration;
+    if(duration > profile->maxduration) {
+        profile->maxduration = duration;
+    }
+    if(latency > profile->maxlatency) {
+        profile->maxlatency = latency;
+    }
+
+    /* What's waiting now was requested during this handler at the latest */
+    waiting = VICIRQStatus & ~irqprofile_waiting;
+    irqprofile_waiting |= waiting;
+    for(channel=0;waiting!=0;channel++,waiting>>=1) {
+        if(waiting & 1) {
+            irqprofile_waitingsince[channel] = start;
+        }
+    }
+
+    #if IRQ_NESTED
+    __critical_exit(status);
+    #endif
+}
+
+error_t irqprofile_get(const unsigned char channel, irqprofile_t *profile)
+/*!
+  Copy the profile of the given VIC channel (or IRQPROFILE_UNKNOWN) to 'profile'.
+  Returns INVALID for an invalid channel
+*/
+{
+    interrupt_t status;
+
+    if(channel > IRQPROFILE_UNKNOWN) {
+        return INVALID;
+    }
+
+    __critical_enter_irq(status);
+    *profile = irqprofile[channel];
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+void irqprofile_reset(void)
+/*!
+  Clear all profiles
+*/
+{
+    interrupt_t status;
+
+    __critical_enter_irq(status);
+    memset(irqprofile, 0, sizeof(irqprofile));
+    irqprofile_waiting = 0;
+    __critical_exit(status);
+}
+
+#if DEBUG
+void irqprofile_report(void)
+/*!
+  Print the profile of every channel that had an IRQ on the debug console
+*/
+{
+    unsigned char channel;
+    irqprofile_t profile;
+
+    dprint("IRQ profile, in timer ticks\n\r");
+    dprint("channel\tcount\tmean\tmax\tlatency\n\r");
+
+    for(channel=0;channel<=IRQPROFILE_UNKNOWN;channel++) {
+        irqprofile_get(channel, &profile);
+        if(profile.count == 0) {
+            continue;
+        }
+        if(channel == IRQPROFILE_UNKNOWN) {
+            dprint("?\t");
+        }
+        else {
+            dprint("%i\t", channel);
+        }
+        dprint("%i\t%i\t%i\t%i\n\r", profile.count, (unsigned int)(profile.total/profile.count), profile.maxduration, profile.maxlatency);
+    }
+}
+#else
+void irqprofile_report(void)
+/*!
+  No debug console, nothing to report
+*/
+{
+}
+#endif /* DEBUG */
+
+#endif /* IRQPROFILE */
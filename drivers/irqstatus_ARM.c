@@ -23,6 +23,7 @@ IRQ/FIQ/VIC status debugging
 #include <irqstatus.h>
 #include <debug.h>
 #include <functionname.h>
+#include <vic.h>
 #include "registers.h"
 
 void irqstatus(void)
@@ -35,6 +36,7 @@ void irqstatus(void)
     unsigned char channel;
     unsigned char vector;
     unsigned int* functionname;
+    unsigned int handler;
 
     dprint("channel\ttype\tenabled\tpending\tvector\thandler\n\r");
     for(channel=0;channel<16;channel++) {
@@ -67,8 +69,8 @@ void irqstatus(void)
             if(VICVectCntlArray[vector] == (unsigned int)(0x20|channel)) {
                 dprint("%i\t",vector);
                 /* Get handler */
-                dprint("[%h]:",VICVectAddrArray[vector]);
-                functionname=__getfunctionname( VICVectAddrArray[vector] );
+                dprint("[%h]:",vic_gethandler(vector));
+                functionname=__getfunctionname( vic_gethandler(vector) );
                 if(functionname) {
                     dprint("%s\t",functionname);
                 }
@@ -82,8 +84,15 @@ void irqstatus(void)
         if(vector==16) {
             dprint("none\t");
             /* Function is found in VICDefVectAddr */
-            dprint("[%h]:",VICDefVectAddr);
-            functionname=__getfunctionname(VICDefVectAddr);
+            handler=vic_gethandler(PRIO_NONVECTOR);
+            #if VIC_DISPATCH
+            /* ..which calls the channel's own handler, when it has one */
+            if(vic_nonvectored & (1<<channel)) {
+                handler=(unsigned int)vic_channelhandlers[channel];
+            }
+            #endif
+            dprint("[%h]:",handler);
+            functionname=__getfunctionname(handler);
             if(functionname) {
                 dprint("%s\t",functionname);
             }
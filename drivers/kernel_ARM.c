@@ -0,0 +1,522 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    kernel_ARM.c:
+                 Preemptive task kernel
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Always compiled in ARM mode, as it reads the CPSR and runs from RAM with IRQ_IN_RAM.
+            -There is one task for each priority, so the ready tasks, the delayed tasks and the
+             tasks waiting on a semaphore are all bitmasks; the highest priority one is found
+             with lowestbit() (see std.h).
+            -All task switches are done in one place: kernel_reschedule() triggers a software
+             interrupt (KERNEL_SOFTINT) in the lowest VIC slot (PRIO_KERNEL), and it's handler
+             sets __kernel_switch. On the way out of that IRQ, IRQHandler (crt0.S) sees it, and
+             jumps to __kernel_contextswitch (kernelswitch_ARM.S). That saves the full context
+             of the current task on it's stack, and loads that of the task __kernel_next() picks.
+             Because it's the lowest priority IRQ, the switch waits until all other handlers are
+             done; it's the same for a switch caused by a task, the tick or any IRQ handler.
+            -A waiting task spins until the switch happens; it only takes the few instructions
+             until the software interrupt is taken.
+
+*/
+/*!
+\file
+Preemptive task kernel
+*/
+#include <config.h>
+
+#if KERNEL
+#include <kernel.h>
+#include <timer.h>
+#include <vic.h>
+#include <irq.h>
+#include <std.h>
+#include <err.h>
+#include <debug.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if IRQ_NESTED
+#error "The kernel cannot be combined with IRQ_NESTED"
+#endif
+#if KERNEL_TIMER != 0 && KERNEL_TIMER != 1
+#error "KERNEL_TIMER must be 0 or 1"
+#endif
+
+#define __KERNEL_TIMER(n, name)     timer##n##_##name
+#define KERNEL_TIMERFN(n, name)     __KERNEL_TIMER(n, name)
+#define __KERNEL_REG(timer, reg)    T##timer##reg
+#define KERNEL_REG(timer, reg)      __KERNEL_REG(timer, reg)
+#define KERNEL_IR                   KERNEL_REG(KERNEL_TIMER, IR)
+
+/* Tasks run in System mode, with IRQ and FIQ enabled. Bit 5 is set for thumb code */
+#define KERNEL_TASKCPSR             0x1F
+#define KERNEL_THUMBBIT             0x20
+/* Mode bits of the CPSR, and their value in IRQ mode */
+#define KERNEL_MODEMASK             0x1F
+#define KERNEL_IRQMODE              0x12
+
+/* The context stored on a task stack by __kernel_contextswitch(): CPSR, r0-r14, and the
+   return address (which is the PC + 4) */
+#define KERNEL_FRAMEWORDS           17
+
+/* The tasks, by priority */
+static task_t *kernel_tasks[KERNEL_TASKS];
+/* Ready and delayed tasks, one bit per priority */
+static volatile unsigned int kernel_ready;
+static volatile unsigned int kernel_delayed;
+static volatile unsigned int kernel_tickcount;
+
+/* main(), after kernel_start() */
+static task_t kernel_idletask = { NULL, NULL, 0, "idle", KERNEL_IDLE, GOOD, 0, NULL };
+
+/* Used by kernelswitch_ARM.S and crt0.S */
+task_t *__kernel_current;
+volatile unsigned int __kernel_switch;
+IRQFUNC task_t *__kernel_next(void);
+
+static IRQFUNC void kernel_softint(void);
+static IRQFUNC void kernel_tick(void);
+static IRQFUNC void kernel_reschedule(void);
+static IRQFUNC void kernel_wake(const unsigned char priority, const error_t result);
+static IRQFUNC void kernel_block(task_t *task, volatile unsigned int *waitingon, const unsigned int timeout);
+static IRQFUNC error_t kernel_waitdone(task_t *task);
+static IRQFUNC error_t kernel_canwait(const task_t *task);
+static void task_exit(void);
+
+error_t kernel_start(void)
+/*!
+  Start the kernel. main() becomes the idle task, and the highest priority task that was
+  started with task_start() runs as soon as IRQ's are enabled. Call this after init()
+*/
+{
+    interrupt_t status;
+
+    if(__kernel_current != NULL) {
+        return BUSY;
+    }
+
+    __critical_enter_irq(status);
+
+    kernel_tasks[KERNEL_IDLE] = &kernel_idletask;
+    kernel_ready |= (1<<KERNEL_IDLE);
+    __kernel_current = &kernel_idletask;
+
+    VICSoftIntClear = (1<<KERNEL_SOFTINT);
+    vic_setup(KERNEL_SOFTINT, IRQ, PRIO_KERNEL, kernel_softint);
+    KERNEL_TIMERFN(KERNEL_TIMER, init)((PCLK/KERNEL_TICK)-1, 0, kernel_tick);
+
+    kernel_reschedule();
+
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+unsigned int kernel_ticks(void)
+/*!
+  Return the amount of ticks since kernel_start()
+*/
+{
+    return kernel_tickcount;
+}
+
+error_t task_start(task_t *task, const TASKFUNCTION function, void *arg, const unsigned char priority)
+/*!
+  Start 'task' (defined with TASK()), which calls 'function' with argument 'arg', at the
+  given priority (0 is the highest, up to KERNEL_IDLE-1). When 'function' returns, the task
+  ends, and can be started again. Returns INVALID for a bad priority, and BUSY when there's a
+  task with that priority already
+*/
+{
+    interrupt_t status;
+    unsigned int *sp;
+    unsigned int i;
+
+    if(priority >= KERNEL_IDLE) {
+        return INVALID;
+    }
+
+    __critical_enter_irq(status);
+    if(kernel_tasks[priority] != NULL) {
+        __critical_exit(status);
+        return BUSY;
+    }
+    kernel_tasks[priority] = task;
+    __critical_exit(status);
+
+    for(i=0;i<task->stacksize/4;i++) {
+        task->stack[i] = KERNEL_STACKFILL;
+    }
+
+    /* Build the context __kernel_contextswitch() loads */
+    sp = task->stack + task->stacksize/4;
+    sp[-1] = ((unsigned int)function & ~1) + 4;     /* Return address.. */
+    sp[-2] = (unsigned int)task_exit;               /* ..r14.. */
+    sp[-3] = (unsigned int)sp;                      /* ..r13.. */
+    for(i=4;i<=15;i++) {
+        sp[-i] = 0;                                 /* ..r12 to r1.. */
+    }
+    sp[-16] = (unsigned int)arg;                    /* ..r0.. */
+    sp[-17] = KERNEL_TASKCPSR;                      /* ..and the CPSR */
+    if((unsigned int)function & 1) {
+        sp[-17] |= KERNEL_THUMBBIT;
+    }
+
+    task->sp = sp - KERNEL_FRAMEWORDS;
+    task->priority = priority;
+    task->waitresult = GOOD;
+    task->waitingon = NULL;
+
+    __critical_enter_irq(status);
+    kernel_ready |= (1<<priority);
+    kernel_reschedule();
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+static void task_exit(void)
+/*
+  A task function returned; remove the task
+*/
+{
+    interrupt_t status;
+    unsigned char priority = __kernel_current->priority;
+
+    __critical_enter_irq(status);
+    kernel_tasks[priority] = NULL;
+    kernel_ready &= ~(1<<priority);
+    kernel_reschedule();
+    __critical_exit(status);
+
+    /* Never runs again */
+    for(;;);
+}
+
+task_t *task_current(void)
+/*!
+  Return the running task, or NULL before kernel_start()
+*/
+{
+    return __kernel_current;
+}
+
+error_t task_sleep(const unsigned int ticks)
+/*!
+  Let the current task wait for the given amount of ticks. Returns INVALID when
+  called from the idle task or an IRQ handler
+*/
+{
+    interrupt_t status;
+    task_t *task = __kernel_current;
+    error_t result;
+
+    result = kernel_canwait(task);
+    if(result != GOOD || ticks == 0) {
+        return result;
+    }
+
+    __critical_enter_irq(status);
+    kernel_block(task, NULL, ticks);
+    __critical_exit(status);
+
+    kernel_waitdone(task);
+
+    return GOOD;
+}
+
+unsigned int task_stackunused(const task_t *task)
+/*!
+  Return the amount of bytes of the task's stack that were never used. The
+  System mode stack of the idle task is not measured; it returns 0
+*/
+{
+    unsigned int i;
+
+    for(i=0;i<task->stacksize/4;i++) {
+        if(task->stack[i] != KERNEL_STACKFILL) {
+            break;
+        }
+    }
+    return i*4;
+}
+
+void semaphore_init(semaphore_t *semaphore, const unsigned int count)
+/*!
+  Initialise a semaphore with the given count
+*/
+{
+    semaphore->count = count;
+    semaphore->waiting = 0;
+}
+
+error_t semaphore_wait(semaphore_t *semaphore, const unsigned int timeout)
+/*!
+  Take the semaphore. When it's count is 0, wait at most 'timeout' ticks (or KERNEL_FOREVER)
+  for a semaphore_post(). Returns GOOD when it was taken, BUSY when it wasn't available and
+  'timeout' is KERNEL_NOWAIT, and TIMEOUT when the timeout passed. Only KERNEL_NOWAIT is
+  allowed in IRQ handlers and the idle task; INVALID is returned otherwise
+*/
+{
+    interrupt_t status;
+    task_t *task = __kernel_current;
+    error_t result;
+
+    __critical_enter_irq(status);
+    if(semaphore->count > 0) {
+        semaphore->count--;
+        __critical_exit(status);
+        return GOOD;
+    }
+    if(timeout == KERNEL_NOWAIT) {
+        __critical_exit(status);
+        return BUSY;
+    }
+    result = kernel_canwait(task);
+    if(result != GOOD) {
+        __critical_exit(status);
+        return result;
+    }
+
+    semaphore->waiting |= (1<<task->priority);
+    kernel_block(task, &semaphore->waiting, timeout);
+    __critical_exit(status);
+
+    return kernel_waitdone(task);
+}
+
+void semaphore_post(semaphore_t *semaphore)
+/*!
+  Release the semaphore; the highest priority task waiting for it gets it. May be called
+  from IRQ handlers
+*/
+{
+    interrupt_t status;
+
+    __critical_enter_irq(status);
+    if(semaphore->waiting) {
+        kernel_wake(lowestbit(semaphore->waiting), GOOD);
+    }
+    else {
+        semaphore->count++;
+    }
+    __critical_exit(status);
+}
+
+void queue_init(queue_t *queue, void **buffer, const unsigned int length)
+/*!
+  Initialise an empty queue, which stores it's messages in 'buffer' ('length' of them)
+*/
+{
+    queue->buffer = buffer;
+    queue->length = length;
+    queue->readpos = 0;
+    queue->writepos = 0;
+    semaphore_init(&queue->items, 0);
+    semaphore_init(&queue->space, length);
+}
+
+error_t queue_put(queue_t *queue, void *message, const unsigned int timeout)
+/*!
+  Add a message to the queue. When it's full, wait at most 'timeout' ticks for room.
+  Returns the same as semaphore_wait(), and the same rules apply
+*/
+{
+    interrupt_t status;
+    error_t result;
+
+    result = semaphore_wait(&queue->space, timeout);
+    if(result != GOOD) {
+        return result;
+    }
+
+    __critical_enter_irq(status);
+    queue->buffer[queue->writepos] = message;
+    if(++queue->writepos == queue->length) {
+        queue->writepos = 0;
+    }
+    __critical_exit(status);
+
+    semaphore_post(&queue->items);
+
+    return GOOD;
+}
+
+error_t queue_get(queue_t *queue, void **message, const unsigned int timeout)
+/*!
+  Take the oldest message from the queue. When it's empty, wait at most 'timeout' ticks
+  for one. Returns the same as semaphore_wait(), and the same rules apply
+*/
+{
+    interrupt_t status;
+    error_t result;
+
+    result = semaphore_wait(&queue->items, timeout);
+    if(result != GOOD) {
+        return result;
+    }
+
+    __critical_enter_irq(status);
+    *message = queue->buffer[queue->readpos];
+    if(++queue->readpos == queue->length) {
+        queue->readpos = 0;
+    }
+    __critical_exit(status);
+
+    semaphore_post(&queue->space);
+
+    return GOOD;
+}
+
+#if DEBUG
+void kernel_report(void)
+/*!
+  Print all tasks, and how much of their stack was never used, on the debug console
+*/
+{
+    unsigned char priority;
+    task_t *task;
+
+    dprint("prio\tname\tstack\tunused\n\r");
+    for(priority=0;priority<KERNEL_IDLE;priority++) {
+        task = kernel_tasks[priority];
+        if(task != NULL) {
+            dprint("%i\t%s\t%i\t%i\n\r", priority, task->name, task->stacksize, task_stackunused(task));
+        }
+    }
+}
+#else
+void kernel_report(void)
+/*!
+  No debug console, nothing to report
+*/
+{
+}
+#endif /* DEBUG */
+
+task_t *__kernel_next(void)
+/*
+  Called by __kernel_contextswitch() (kernelswitch_ARM.S) to pick the task to run
+*/
+{
+    __kernel_current = kernel_tasks[lowestbit(kernel_ready)];
+
+    return __kernel_current;
+}
+
+static void kernel_softint(void)
+/*
+  The software interrupt triggered by kernel_reschedule(). Have IRQHandler (crt0.S)
+  switch tasks when this handler is done
+*/
+{
+    VICSoftIntClear = (1<<KERNEL_SOFTINT);
+    __kernel_switch = 1;
+}
+
+static void kernel_tick(void)
+/*
+  Timer interrupt; wake the tasks of which the delay has passed
+*/
+{
+    unsigned int delayed;
+    unsigned char priority;
+    task_t *task;
+
+    KERNEL_IR = BIT_IR_MR0;
+    kernel_tickcount++;
+
+    delayed = kernel_delayed;
+    while(delayed) {
+        priority = lowestbit(delayed);
+        task = kernel_tasks[priority];
+        if(--task->delay == 0) {
+            kernel_wake(priority, TIMEOUT);
+        }
+        /* Clear the lowest bit */
+        delayed &= delayed - 1;
+    }
+}
+
+static void kernel_reschedule(void)
+/*
+  Trigger a task switch when the highest priority ready task isn't the one running.
+  Called with IRQ disabled
+*/
+{
+    if(__kernel_current != NULL && lowestbit(kernel_ready) != __kernel_current->priority) {
+        VICSoftInt = (1<<KERNEL_SOFTINT);
+    }
+}
+
+static void kernel_wake(const unsigned char priority, const error_t result)
+/*
+  Make the waiting task with the given priority ready again. 'result' is what the wait
+  returns. Called with IRQ disabled
+*/
+{
+    task_t *task = kernel_tasks[priority];
+
+    if(task->waitingon != NULL) {
+        *task->waitingon &= ~(1<<priority);
+        task->waitingon = NULL;
+    }
+    kernel_delayed &= ~(1<<priority);
+    task->waitresult = result;
+    kernel_ready |= (1<<priority);
+
+    kernel_reschedule();
+}
+
+static void kernel_block(task_t *task, volatile unsigned int *waitingon, const unsigned int timeout)
+/*
+  Make 'task' wait for 'waitingon' (a semaphore), or a timeout. Called with IRQ disabled;
+  the switch to another task happens when IRQ is enabled again
+*/
+{
+    task->waitingon = waitingon;
+    if(timeout != KERNEL_FOREVER) {
+        task->delay = timeout;
+        kernel_delayed |= (1<<task->priority);
+    }
+    kernel_ready &= ~(1<<task->priority);
+
+    kernel_reschedule();
+}
+
+static error_t kernel_waitdone(task_t *task)
+/*
+  Wait until 'task' (the current one) is ready again, and return why. Called with IRQ enabled
+*/
+{
+    while(!(kernel_ready & (1<<task->priority)));
+
+    return task->waitresult;
+}
+
+static error_t kernel_canwait(const task_t *task)
+/*
+  Returns GOOD when 'task' (the current one) may wait; not when running the idle task or
+  an IRQ handler, or before kernel_start()
+*/
+{
+    unsigned int cpsr;
+
+    asm volatile ("mrs     %0, cpsr" : "=r" (cpsr));
+    if(task == NULL || task->priority == KERNEL_IDLE || (cpsr & KERNEL_MODEMASK) == KERNEL_IRQMODE) {
+        return INVALID;
+    }
+    return GOOD;
+}
+
+#endif /* KERNEL */
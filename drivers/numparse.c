@@ -0,0 +1,198 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    numparse.c:
+               Streaming number parser
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Unlike strtoint(), this doesn't need the whole number in a '\0' terminated
+             string. Bytes are fed one at a time (numparse_putc(), from an ISR for example)
+             or in spans (numparse_feed(), numparse_ringbuffer()), as they arrive.
+            -Leading spaces and tabs are skipped. The number ends at the first byte that
+             isn't a digit in the given base; that byte is not consumed, so the caller
+             can check what ended the number (a ',' or '\r' for example). When the input
+             ends right after the last digit, call numparse_finish().
+            -Overflow is checked without a division per digit; the limits are calculated
+             once, when the parser is initialised (or a '-' is seen).
+
+*/
+/*!
+\file
+Streaming number parser
+*/
+#include <numparse.h>
+#include <std.h>
+#include <err.h>
+
+/* Largest magnitude of a result, unsigned, signed positive and signed negative */
+#define NUMPARSE_MAXUNSIGNED    0xFFFFFFFF
+#define NUMPARSE_MAXPOSITIVE    0x7FFFFFFF
+#define NUMPARSE_MAXNEGATIVE    0x80000000
+
+static void numparse_setlimit(numparse_t *parser, const unsigned int max)
+/*
+  Calculate the overflow limits for the given maximum value
+*/
+{
+    parser->cutoff=max/parser->base;
+    parser->cutlim=max%parser->base;
+}
+
+error_t numparse_init(numparse_t *parser, const unsigned char base, const bool allowsign)
+/*!
+  (Re)initialise the parser for a new number in the given base (2 to 36). When
+  'allowsign' is set, an optional '+' or '-' may precede the digits, and the
+  result is limited to the range of an int. Otherwise the range is that of
+  an unsigned int.
+*/
+{
+    if(base < 2 || base > 36) {
+        return INVALID;
+    }
+
+    parser->value=0;
+    parser->base=base;
+    parser->state=NUMPARSE_START;
+    parser->allowsign=allowsign;
+    parser->negative=FALSE;
+    numparse_setlimit(parser, allowsign ? NUMPARSE_MAXPOSITIVE : NUMPARSE_MAXUNSIGNED);
+
+    return GOOD;
+}
+
+unsigned char numparse_putc(numparse_t *parser, const unsigned char c)
+/*!
+  Feed a single byte to the parser. Returns the new state; once that is
+  NUMPARSE_DONE or worse, further bytes are ignored until numparse_init() is called again.
+*/
+{
+    unsigned char digit;
+
+    if(parser->state >= NUMPARSE_DONE) {
+        return parser->state;
+    }
+
+    digit=digitvalue(c);
+    if(digit >= parser->base) {
+        if(parser->state == NUMPARSE_DIGITS) {
+            /* End of the number */
+            parser->state=NUMPARSE_DONE;
+        }
+        else if(parser->state == NUMPARSE_START && (c == ' ' || c == '\t')) {
+            /* Skip leading whitespace */
+        }
+        else if(parser->state == NUMPARSE_START && parser->allowsign && (c == '-' || c == '+')) {
+            if(c == '-') {
+                parser->negative=TRUE;
+                numparse_setlimit(parser, NUMPARSE_MAXNEGATIVE);
+            }
+            parser->state=NUMPARSE_SIGN;
+        }
+        else {
+            parser->state=NUMPARSE_INVALID;
+        }
+        return parser->state;
+    }
+
+    if(parser->value > parser->cutoff || (parser->value == parser->cutoff && digit > parser->cutlim)) {
+        parser->state=NUMPARSE_OVERFLOW;
+        return parser->state;
+    }
+    parser->value=parser->value*parser->base + digit;
+    parser->state=NUMPARSE_DIGITS;
+
+    return parser->state;
+}
+
+unsigned int numparse_feed(numparse_t *parser, const unsigned char *data, const unsigned int length)
+/*!
+  Feed 'length' bytes to the parser. Returns the amount of bytes consumed; this
+  is less than 'length' when the number ended (or an error was found) within
+  the given data. The byte that ended the number is not consumed.
+*/
+{
+    unsigned int i;
+
+    for(i=0;i<length;i++) {
+        if(numparse_putc(parser, data[i]) >= NUMPARSE_DONE) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+unsigned int numparse_ringbuffer(numparse_t *parser, ringbufferctrl_t *ringbuffer)
+/*!
+  Feed the data in the ringbuffer to the parser, and remove the consumed bytes
+  from it. The data is parsed in place, in (at most) two contiguous spans.
+  Returns the amount of bytes consumed.
+*/
+{
+    unsigned int readpos=ringbuffer->readpos;
+    unsigned int writepos=ringbuffer->writepos;
+    unsigned int span;
+    unsigned int consumed;
+
+    if(readpos <= writepos) {
+        /* No wrap-around, all data is in one span */
+        consumed=numparse_feed(parser, ringbuffer->data+readpos, writepos-readpos);
+    }
+    else {
+        /* Data wraps around; first up to the end of the buffer.. */
+        span=ringbuffer->length-readpos;
+        consumed=numparse_feed(parser, ringbuffer->data+readpos, span);
+        if(consumed == span) {
+            /* ..then the rest from the start */
+            consumed+=numparse_feed(parser, ringbuffer->data, writepos);
+        }
+    }
+    ringbuffer_skip(ringbuffer, 1, consumed);
+
+    return consumed;
+}
+
+unsigned char numparse_finish(numparse_t *parser)
+/*!
+  Tell the parser the input has ended. A number that was still being parsed is
+  now complete; when no digits were seen at all, the state becomes NUMPARSE_INVALID.
+  Returns the new state.
+*/
+{
+    if(parser->state == NUMPARSE_DIGITS) {
+        parser->state=NUMPARSE_DONE;
+    }
+    else if(parser->state < NUMPARSE_DONE) {
+        parser->state=NUMPARSE_INVALID;
+    }
+
+    return parser->state;
+}
+
+error_t numparse_result(const numparse_t *parser, unsigned int *value)
+/*!
+  Get the parsed number. Returns GOOD (and stores the number in 'value') when
+  the parser is done, BUSY when it needs more input, and INVALID or OVERFLOW
+  on errors. Negative numbers are returned in two's complement; cast them to int.
+*/
+{
+    switch(parser->state) {
+        case NUMPARSE_DONE:
+            *value = parser->negative ? 0-parser->value : parser->value;
+            return GOOD;
+        case NUMPARSE_INVALID:
+            return INVALID;
+        case NUMPARSE_OVERFLOW:
+            return OVERFLOW;
+        default:
+            return BUSY;
+    }
+}
@@ -14,6 +14,9 @@
 
     remarks:
             -If the PLL doesn't lock, the CPU will hang.
+            -crt0.S already sets up the PLL, MAM and VPB, before initialising memory.
+             pll_init() checks for that, and only touches the hardware when the settings
+             are not what config.h asks for.
 
 */
 /*!
@@ -25,12 +28,38 @@ PLL, MAM & VPB initialisation
 #include "registers.h"
 #include <debug.h>
 
+static bool pll_isconfigured(void)
+/*
+  Check if the PLL, MAM and VPB are already set up as configured in config.h
+*/
+{
+    #if PLL_MUL > 1
+    /* PLLSTAT mirrors PLLCFG in it's lower bits */
+    if((PLLSTAT & (PLLSTAT_PLLE | PLLSTAT_PLLC | PLLSTAT_LOCK | 0x7F)) != (PLLSTAT_PLLE | PLLSTAT_PLLC | PLLSTAT_LOCK | PLLCFG_MSEL | PLLCFG_PSEL)) {
+        return FALSE;
+    }
+    #else
+    if(PLLSTAT & (PLLSTAT_PLLE | PLLSTAT_PLLC)) {
+        return FALSE;
+    }
+    #endif
+
+    return MAMCR == MAMCR_FULL && MAMTIM == MAMTIM_CYCLES && (VPBDIV & 0x03) == (PBSD & 0x03);
+}
+
 void pll_init(void)
 /*!
-  Initialise the PLL, MAM and VPB
+  Initialise the PLL, MAM and VPB, if that has not been done already
 */
 {
-    __store_interrupts(&__interrupt_status);
+    interrupt_t status;
+
+    if(pll_isconfigured()) {
+        /* Nothing to do, crt0.S took care of it */
+        return;
+    }
+
+    __critical_enter(status);
 
     /* Start the PLL, but only if needed */
     #if PLL_MUL > 1
@@ -68,7 +97,7 @@ void pll_init(void)
     /* Set VPB clock */
     VPBDIV = PBSD & 0x03;
 
-    __restore_interrupts(&__interrupt_status);
+    __critical_exit(status);
 }
 
 void pll_switch(unsigned char multiplier)
@@ -77,7 +106,9 @@ void pll_switch(unsigned char multiplier)
   A lot of clock-base stuff won't work after the switch (think baudrates, delays, ...)
 */
 {
-    __store_interrupts(&__interrupt_status);
+    interrupt_t status;
+
+    __critical_enter(status);
 
     /* Disable the Memory Accelerator Module */
     MAMCR = MAMCR_OFF;
@@ -106,5 +137,27 @@ void pll_switch(unsigned char multiplier)
     PLLFEED = 0x000000AA;
     PLLFEED = 0x00000055;
 
-    __restore_interrupts(&__interrupt_status);
-}
\ No newline at end of file
+    __critical_exit(status);
+}
+unsigned int pll_pclk(void)
+/*!
+  Return the current peripheral clock in Hz, as the PLL and VPB divider are set right now
+  (which is only PCLK from types.h once pll_init() ran)
+*/
+{
+    unsigned int cclk = FOSC;
+
+    if(PLLSTAT & PLLSTAT_PLLC) {
+        /* PLLSTAT mirrors PLLCFG in it's lower bits */
+        cclk *= (PLLSTAT & 0x1F) + 1;
+    }
+
+    switch(VPBDIV & 0x03) {
+        case 1:
+            return cclk;
+        case 2:
+            return cclk / 2;
+        default:
+            return cclk / 4;
+    }
+}
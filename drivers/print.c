@@ -32,27 +32,23 @@ void print_open(void * localputchar)
     printputchar=localputchar;
 }
 
-void fprint(void (* localputchar)(unsigned char c), char *fmt, ...)
+void print_format(const printout_t out, void *arg, char *fmt, va_list argpointer)
 /*!
-  Simple fprintf like function, based on code from the 'C-handboek', page 212
+  The actual formatting engine, based on code from the 'C-handboek', page 212.
+  Each resulting character is passed to 'out', together with 'arg'; this way
+  fprint(), sprint() and friends can all share this code.
 */
 {
-    char c[32];
+    char c[34];
     char* string;
     unsigned char base=0;
 
-    /* Create an object containing all given arguments */
-    va_list argpointer;
-
-    /* Initialise argpointer, so it points to the first argument given */
-    va_start(argpointer, fmt);
-
     /* Walk through al the given arguments */
     for(;*fmt;fmt++) {
         /* Is it a variable? */
         if(*fmt != '%') {
             /* Nope, so just print it */
-            localputchar(*fmt);
+            out(*fmt, arg);
         }
         else {
             /* It is.. What kind? */
@@ -61,12 +57,12 @@ void fprint(void (* localputchar)(unsigned char c), char *fmt, ...)
                     /* string */
                     for(string=va_arg(argpointer, char *); *string; string++) {
                         /* Walk through the entire string, printing each character */
-                        localputchar(*string);
+                        out(*string, arg);
                     }
                     break;
                 case 'c':
                     /* char */
-                    localputchar(va_arg(argpointer, int));
+                    out(va_arg(argpointer, int), arg);
                     break;
                 case 'b':
                     /* binair */
@@ -85,7 +81,7 @@ void fprint(void (* localputchar)(unsigned char c), char *fmt, ...)
                     base=16;
                     break;
                 default:
-                    localputchar(*fmt);
+                    out(*fmt, arg);
                     break;
             }
             if(base!=0) {
@@ -94,25 +90,57 @@ void fprint(void (* localputchar)(unsigned char c), char *fmt, ...)
                 /* ..and print it */
                 for(string=c; *string; string++) {
                     /* Walk through the entire string, printing each character */
-                    localputchar(*string);
+                    out(*string, arg);
                 }
                 base=0;
             }
         }
     }
+}
+
+static void fprint_out(unsigned char c, void *arg)
+/*
+  print_format() output for fprint(); 'arg' is the putchar function
+*/
+{
+    ((void (*)(unsigned char))arg)(c);
+}
+
+void fprint(void (* localputchar)(unsigned char c), char *fmt, ...)
+/*!
+  Simple fprintf like function
+*/
+{
+    /* Create an object containing all given arguments */
+    va_list argpointer;
+
+    /* Initialise argpointer, so it points to the first argument given */
+    va_start(argpointer, fmt);
+
+    print_format(fprint_out, (void *)localputchar, fmt, argpointer);
 
     /* free memory n' stuff.. */
     va_end(argpointer);
 }
 
+static void sprint_out(unsigned char c, void *arg)
+/*
+  print_format() output for sprint(); 'arg' points to the current output position
+*/
+{
+    char **output = arg;
+
+    **output = c;
+    (*output)++;
+}
+
 unsigned int sprint(char c[], char *fmt, ...)
 /*!
   Simple sprintf like function. Very similair to print(), only the output is done in 'c[]'
   instead of the output-device
 */
 {
-    char *string;
-    int outputcounter=0;
+    char *output=c;
 
     /* Create an object containing all given arguments */
     va_list argpointer;
@@ -120,58 +148,12 @@ unsigned int sprint(char c[], char *fmt, ...)
     /* Initialise argpointer, so it points to the first argument given */
     va_start(argpointer, fmt);
 
-    /* Walk through al the given arguments */
-    for(;*fmt;fmt++) {
-        /* Is it a variable? */
-        if(*fmt != '%') {
-            /* Nope, so just print it */
-            c[outputcounter]=*fmt;
-            outputcounter++;
-        }
-        else {
-            /* It is.. What kind? */
-            switch(*++fmt) {
-                case 's':
-                    /* string */
-                    for(string=va_arg(argpointer, char *); *string; string++) {
-                        /* Walk through the entire screen, printing each character */
-                        c[outputcounter]=*string;
-                        outputcounter++;
-                    }
-                    break;
-                case 'c':
-                    /* char */
-                    c[outputcounter]=(char)va_arg(argpointer, int);
-                    outputcounter++;
-                    break;
-                case 'b':
-                    /* binair */
-                    outputcounter+=inttostr((char)va_arg(argpointer, int),&c[outputcounter],2);
-                    break;
-                case 'd':
-                    /* Fall through */
-                case 'i':
-                    /* int */
-                    outputcounter+=inttostr(va_arg(argpointer, int),&c[outputcounter],10);
-                    break;
-                case 'h':
-                    /* Fall through */
-                case 'x':
-                    /* hex */
-                    outputcounter+=inttostr(va_arg(argpointer, int),&c[outputcounter],16);
-                    break;
-                default:
-                    c[outputcounter]=*fmt;
-                    outputcounter++;
-                    break;
-            }
-        }
-    }
-    c[outputcounter]='\0';
+    print_format(sprint_out, &output, fmt, argpointer);
+    *output='\0';
 
     /* free memory n' stuff.. */
     va_end(argpointer);
 
     /* Return length of created string */
-    return outputcounter;
+    return output-c;
 }
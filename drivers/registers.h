@@ -354,7 +354,7 @@ LPC2000 register definitions
 #define T3PC            (*(volatile unsigned short *)(__MCU_APB_BASE + 0x74010))
 #define T3MCR           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x74014))
 #define T3MR0           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x74018))
-#define T3MR4           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x7401C))
+#define T3MR1           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x7401C))
 #define T3MR2           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x74020))
 #define T3MR3           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x74024))
 #define T3CCR           (*(volatile unsigned short *)(__MCU_APB_BASE + 0x74028))
@@ -484,7 +484,16 @@ LPC2000 register definitions
   APB address space
 */
 
+T0TC                = __MCU_APB_BASE + 0x04008
+T1TC                = __MCU_APB_BASE + 0x08008
+MAMCR               = __MCU_APB_BASE + 0x1fc000
+MAMTIM              = __MCU_APB_BASE + 0x1fc004
 MEMMAP              = __MCU_APB_BASE + 0x1fc040
+PLLCON              = __MCU_APB_BASE + 0x1fc080
+PLLCFG              = __MCU_APB_BASE + 0x1fc084
+PLLSTAT             = __MCU_APB_BASE + 0x1fc088
+PLLFEED             = __MCU_APB_BASE + 0x1fc08c
+VPBDIV              = __MCU_APB_BASE + 0x1fc100
 VICDefVectAddr      = __MCU_AHB_BASE + 0xffff034
 VICVectAddr         = __MCU_AHB_BASE + 0xffff030
 
@@ -23,9 +23,6 @@ General purpose ringbuffer
 #include "ringbuffer.h"
 #include "debug.h"
 
-/* Uncomment the following to enable debug-output */
-//#define DEBUG_RINGBUFFER
-
 void ringbuffer_init(ringbufferctrl_t *ringbuffer, unsigned char *buffer, unsigned int bufferlength)
 /**
   Initialise ringbuffer
@@ -49,15 +46,11 @@ size_t ringbuffer_write(ringbufferctrl_t *ringbuffer, const void *pointer, const
     /* Figure out how much bytes we have to write */
     towrite = length * size;
 
-    #ifdef DEBUG_RINGBUFFER
-    dprint("ringbuffer_write(): towrite=%i, readpos = %i, writepos = %i, free = %i\n\r",towrite, ringbuffer->readpos, ringbuffer->writepos, ringbuffer_getfreebytes(ringbuffer));
-    #endif
+    dxinfo(DMOD_RINGBUFFER, "ringbuffer_write(): towrite=%i, readpos = %i, writepos = %i, free = %i\n\r",towrite, ringbuffer->readpos, ringbuffer->writepos, ringbuffer_getfreebytes(ringbuffer));
 
     if(towrite > ringbuffer_getfreebytes(ringbuffer)) {
         /* This won't do; too much data */
-        #ifdef DEBUG_RINGBUFFER
-        dprint("ringbuffer_write(): Too much data, abort! (%i > %i)\n\r",towrite,ringbuffer_getfreebytes(ringbuffer));
-        #endif
+        dxinfo(DMOD_RINGBUFFER, "ringbuffer_write(): Too much data, abort! (%i > %i)\n\r",towrite,ringbuffer_getfreebytes(ringbuffer));
         return 0;
     }
 
@@ -84,9 +77,7 @@ signed short ringbuffer_peek(ringbufferctrl_t *ringbuffer, const size_t offset)
 {
     unsigned int peekpos;
 
-    #ifdef DEBUG_RINGBUFFER
-    dprint("ringbuffer_peek(): offset = %i, readpos = %i, writepos = %i, free = %i\n\r", offset, ringbuffer->readpos, ringbuffer->writepos, ringbuffer_getfreebytes(ringbuffer));
-    #endif
+    dxinfo(DMOD_RINGBUFFER, "ringbuffer_peek(): offset = %i, readpos = %i, writepos = %i, free = %i\n\r", offset, ringbuffer->readpos, ringbuffer->writepos, ringbuffer_getfreebytes(ringbuffer));
 
     if(offset < 0 || offset >= ringbuffer->length || ringbuffer_isempty(ringbuffer)) {
         /* Invalid offset, or no data at all */
@@ -105,9 +96,7 @@ signed short ringbuffer_peek(ringbufferctrl_t *ringbuffer, const size_t offset)
         return -1;
     }
 
-    #ifdef DEBUG_RINGBUFFER
-    dprint("ringbuffer_peek(): peekpos = %i\n\r", peekpos);
-    #endif
+    dxinfo(DMOD_RINGBUFFER, "ringbuffer_peek(): peekpos = %i\n\r", peekpos);
 
     return ringbuffer->data[peekpos];
 }
@@ -124,15 +113,11 @@ size_t ringbuffer_read(ringbufferctrl_t *ringbuffer, void *pointer, const size_t
     /* Figure out how much bytes we have to read */
     toread = length * size;
 
-    #ifdef DEBUG_RINGBUFFER
-    dprint("ringbuffer_read(): toread = %i, readpos = %i, writepos = %i, free = %i\n\r", toread, ringbuffer->readpos, ringbuffer->writepos, ringbuffer_getfreebytes(ringbuffer));
-    #endif
+    dxinfo(DMOD_RINGBUFFER, "ringbuffer_read(): toread = %i, readpos = %i, writepos = %i, free = %i\n\r", toread, ringbuffer->readpos, ringbuffer->writepos, ringbuffer_getfreebytes(ringbuffer));
 
     if(toread > ringbuffer_getusedbytes(ringbuffer)) {
         /* Do nothing */
-        #ifdef ringbufferdebug
-        DEBUG("ringbuffer_read(): too much data, leave\n\r");
-        #endif
+        dxinfo(DMOD_RINGBUFFER, "ringbuffer_read(): too much data, leave\n\r");
         return 0;
     }
 
@@ -27,6 +27,7 @@ RTC driver
 
 #include <types.h>
 #include <vic.h>
+#include <err.h>
 #include "registers.h"
 
 static void (* rtccounterintHandler)(void);
@@ -34,12 +35,17 @@ static void (* rtcalarmintHandler)(void);
 
 static void rtc_intHandler(void);
 
-void rtc_init(const bool reset, const bool use_external_clk, const FUNCTION counter_callback, const FUNCTION alarm_callback)
+error_t rtc_init(const bool reset, const bool use_external_clk, const FUNCTION counter_callback, const FUNCTION alarm_callback)
 /*!
   Configure and start the RTC.
   'use_external_clk' is ignored when RTC_HASEXTERNALCLK is undefined
+  Returns BUSY when PRIO_RTC is the VIC slot of a software interrupt in use (see vic.h).
 */
 {
+    if(vic_softintslot(PRIO_RTC)) {
+        return BUSY;
+    }
+
     /* Clear interrupt flags */
     ILR = 0x03;     /* Clear both Counter(0) and Alarm(1) flag */
     /* And disable all interrupts */
@@ -87,6 +93,8 @@ void rtc_init(const bool reset, const bool use_external_clk, const FUNCTION coun
     #ifdef RTC_HASEXTERNALCLK
     }
     #endif
+
+    return GOOD;
 }
 
 void rtc_setcounterinterrupts(const unsigned char bits)
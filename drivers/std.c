@@ -23,6 +23,7 @@ Some all-around functions
 */
 #include <std.h>
 #include <types.h>
+#include "std_bits.h"
 
 /*! The maximum length of a number. For a 32 bit CPU, 32 is a good value */
 #define STD_MAXNUMLENGTH    32
@@ -104,14 +105,16 @@ unsigned int strtoint(char *c, const unsigned char base)
 */
 {
     unsigned int result = 0;
+    unsigned char digit;
     #if STD_SUPPORTNEGATIVE
     bool negative=FALSE;
     #endif
 
     while(*c) {
-        if(isdigit(*c,base)) {
+        digit=digitvalue(*c);
+        if(digit < base) {
             result *= base;
-            result += ctoi(*c,base);
+            result += digit;
         }
         #if STD_SUPPORTNEGATIVE
         else if(result==0 && *c == '-') {
@@ -129,6 +132,27 @@ unsigned int strtoint(char *c, const unsigned char base)
     return result;
 }
 
+/* Value of each ASCII character when used as a digit, STD_NODIGIT when it's not a digit
+   at all. Letters (both cases) are digits 10 to 35, so this works up to base 36 */
+#define ND  STD_NODIGIT
+const unsigned char std_digitvalue[128] = {
+    ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND,
+    ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND,
+    ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND, ND,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, ND, ND, ND, ND, ND, ND,
+    ND, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, ND, ND, ND, ND, ND,
+    ND, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, ND, ND, ND, ND, ND
+};
+#undef ND
+
+/* Bit numbers for lowestbit(), indexed by the upper 5 bits of (1<<bit) * 0x077CB531 */
+const unsigned char std_debruijn[32] = {
+     0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+    31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
+
 unsigned char ctoi(const unsigned char c, const unsigned char base)
 /*!
   Convert the given ASCII character to the corresponding number, using the given base.
@@ -136,38 +160,16 @@ unsigned char ctoi(const unsigned char c, const unsigned char base)
   Use isdigit() for that.
 */
 {
-    if (c >= 'a' && base > 10) {
-        return c-'a'+10;
-    }
-
-    if (c >= 'A' && base > 10) {
-        return c-'A'+10;
-    }
-
-    return c-'0';
+    return digitvalue(c);
 }
 
 int isdigit(const unsigned char c, const unsigned char base)
 /*!
   Determine wheter the given char is a digit according to the given base.
-  We assume ASCII encoding here, so '0' < 'A' < 'a'.
+  We assume ASCII encoding here.
 */
 {
-    if (c < '0') {
-        /* This is not a diget, no matter what base.. */
-        return FALSE;
-    }
-    if (base > 10) {
-        if ((c >= 'a' && c <= 'a' + base-11) || (c >= 'A' && c <= 'A' + base-11)) {
-            return TRUE;
-        }
-    }
-
-    if (c >= '0' && c <= '0' + base-1) {
-        return TRUE;
-    }
-
-    return FALSE;
+    return digitvalue(c) < base;
 }
 
 /*******************************************************************************
@@ -193,17 +195,57 @@ int fpow(const int ground, const int n)
   string functions
 */
 
-void toupper(char *c)
-/*!
-  Convert all characters (a-z) to uppercase
+/* The case conversion functions below work on four characters at a time. For
+   each byte in a word, CASEMASK() gives 0x20 when that byte is in the range
+   'lo' to 'hi' (and 0 otherwise), so XOR-ing the word with it flips the case
+   of just those characters. Bytes with the high bit set are left alone, and
+   since all bytes are limited to 7 bits before adding, no carry can spill over
+   into the next byte. */
+#define CASEMASK(w, lo, hi) ((( ((w) & 0x7F7F7F7F) + (0x80 - (lo)) * 0x01010101) & \
+                              ~(((w) & 0x7F7F7F7F) + (0x80 - (hi) - 1) * 0x01010101) & \
+                              ~(w) & 0x80808080) >> 2)
+
+static void changecase(char *c, const unsigned char lo, const unsigned char hi)
+/*
+  Flip the case of all characters between 'lo' and 'hi'
 */
 {
-    while( *c ) {
-        if((*c >= 'a') && (*c <= 'z')) {
-            *c-=('a'-'A');
+    word *w;
+
+    /* Bytewise up to a word boundary.. */
+    while(((unsigned int)c & 3) && *c) {
+        if(*c >= lo && *c <= hi) {
+            *c ^= 0x20;
         }
         c++;
     }
+    if(*c == '\0') {
+        return;
+    }
+
+    /* ..wordwise up to the word containing the '\0'.. */
+    w = (word *)(void *)c;
+    while(!HASZERO(*w)) {
+        *w ^= CASEMASK(*w, lo, hi);
+        w++;
+    }
+
+    /* ..and bytewise for the last few */
+    c = (char *)w;
+    while(*c) {
+        if(*c >= lo && *c <= hi) {
+            *c ^= 0x20;
+        }
+        c++;
+    }
+}
+
+void toupper(char *c)
+/*!
+  Convert all characters (a-z) to uppercase
+*/
+{
+    changecase(c, 'a', 'z');
 }
 
 void tolower(char *c)
@@ -211,10 +253,5 @@ void tolower(char *c)
   Convert all characters (A-Z) to lowercase
 */
 {
-    while( *c ) {
-        if((*c >= 'A') && (*c <= 'Z')) {
-            *c+=('a'-'A');
-        }
-        c++;
-    }
+    changecase(c, 'A', 'Z');
 }
@@ -1,8 +1,8 @@
 /*
     ALDS (ARM LPC Driver Set)
 
-    irq.c:
-          Low-level interrupt functions
+    std_bits.h:
+               Word-at-a-time string helpers
 
     copyright:
               Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
@@ -13,13 +13,18 @@
               version 2 of the License, or (at your option) any later version.
 
     remarks:
-           -
+            -Used by std.c and std_string.c, which work on strings a word (4 characters) at a
+             time where they can. Meant for these drivers only, not for global inclusion.
 
 */
 /*!
 \file
-Low-level interrupt functions
+Word-at-a-time string helpers
 */
+#ifndef STD_BITS_H
+#define STD_BITS_H
 
-/*! To temporally store the interruptstatus, the following variable is used */
-unsigned int __interrupt_status;
+/* Non-zero when one (or more) of the bytes in 'w' is zero */
+#define HASZERO(w)          (((w) - 0x01010101) & ~(w) & 0x80808080)
+
+#endif /* STD_BITS_H */
@@ -21,35 +21,100 @@
 Some basic string functions
 */
 #include <std_string.h>
+#include <types.h>
+#include "std_bits.h"
+
+/*! The substring search (strstr()) uses a shift table on the stack, indexed by
+    character. To keep the stack usage down, characters share table entries; a
+    larger table gives longer average shifts. Must be a power of 2, 256 max. */
+#define STRSTR_SHIFTTABLESIZE   64
+
+/* Most functions here work a word (4 characters) at a time once the pointers
+   are word-aligned. The end of a string in such a word is found with HASZERO()
+   (see std_bits.h). */
+
+/* True when 'p' is word-aligned */
+#define ALIGNED(p)          (((unsigned int)(p) & 3) == 0)
+/* True when 'a' and 'b' have the same alignment, and thus can be aligned at once */
+#define SAMEALIGN(a, b)     ((((unsigned int)(a) ^ (unsigned int)(b)) & 3) == 0)
+/* Access a (aligned) character pointer as a word pointer */
+#define WORDPTR(p)          ((word *)(void *)(p))
+#define CWORDPTR(p)         ((const word *)(const void *)(p))
+
+/* Note that the word loops may read past the terminating '\0', but never past the
+   word it's in. Since a word never crosses a memory boundary, that's harmless. */
 
 unsigned int strlen(const char *s)
 /*!
   Determine length of given string, max length is sizeof(unsigned int)
 */
 {
-    unsigned int i=0;
+    const char *p=s;
+    const word *w;
 
-    while(*s) {
-        s++;
-        i++;
+    /* Walk bytewise up to a word boundary.. */
+    while(!ALIGNED(p)) {
+        if(*p == '\0') {
+            return p-s;
+        }
+        p++;
+    }
+
+    /* ..then wordwise until we find the word containing the '\0'.. */
+    w = CWORDPTR(p);
+    while(!HASZERO(*w)) {
+        w++;
     }
 
-    return i;
+    /* ..and bytewise again to find it's exact location */
+    p = (const char *)w;
+    while(*p) {
+        p++;
+    }
+
+    return p-s;
 }
 
 char *strcat(char *dest, const char *src)
 /*!
   Concatenate two strings, or in other words add 'src' to 'dest'
 */
+{
+    /* Find end of dest, then add src to it */
+    strcpy(dest+strlen(dest), src);
+
+    return dest;
+}
+
+char *strcpy(char *dest, const char *src)
+/*!
+  Copy a string
+*/
 {
     char *begin=dest;
+    word *wd;
+    const word *ws;
 
-    /* Find end of src */
-    while(*dest) {
-        dest++;
+    if(SAMEALIGN(dest, src)) {
+        /* Copy bytewise up to a word boundary.. */
+        while(!ALIGNED(src)) {
+            if((*dest = *src) == '\0') {
+                return begin;
+            }
+            dest++;
+            src++;
+        }
+        /* ..and wordwise up to the word containing the '\0' */
+        wd = WORDPTR(dest);
+        ws = CWORDPTR(src);
+        while(!HASZERO(*ws)) {
+            *wd++ = *ws++;
+        }
+        dest = (char *)wd;
+        src = (const char *)ws;
     }
 
-    /* Add src to the end of dest */
+    /* Copy the remainder (or everything, for misaligned strings) bytewise */
     while(*src) {
         *dest=*src;
         dest++;
@@ -61,71 +126,344 @@ char *strcat(char *dest, const char *src)
     return begin;
 }
 
-char *strcpy(char *dest, const char *src)
+char *strncpy(char *dest, const char *src, size_t n)
 /*!
-  Copy a string
+  Copy a string, but no more than 'n' characters. When 'src' is shorter than
+  'n', the remainder of 'dest' is filled with '\0'
 */
 {
     char *begin=dest;
+    word *wd;
+    const word *ws;
 
-    while(*src) {
+    if(SAMEALIGN(dest, src)) {
+        while(n && !ALIGNED(src)) {
+            if((*dest = *src) == '\0') {
+                break;
+            }
+            dest++;
+            src++;
+            n--;
+        }
+        if(n && *src) {
+            wd = WORDPTR(dest);
+            ws = CWORDPTR(src);
+            while(n >= 4 && !HASZERO(*ws)) {
+                *wd++ = *ws++;
+                n -= 4;
+            }
+            dest = (char *)wd;
+            src = (const char *)ws;
+        }
+    }
+
+    while(n && *src) {
         *dest=*src;
         dest++;
         src++;
+        n--;
     }
-    /* Terminate string */
-    *dest='\0';
+
+    /* Pad with zero's */
+    memset(dest, '\0', n);
 
     return begin;
 }
 
-char *strncpy(char *dest, const char *src, int n)
+int strcmp(const char *s1, const char *s2)
 /*!
-  Copy a string, but no more than 'n' characters
+  Compare two strings. Returns 0 when equal, < 0 when 's1' is less than 's2'
+  and > 0 when 's1' is greater than 's2'
 */
 {
-    char *begin=dest;
+    const word *w1;
+    const word *w2;
 
-    while(*src && n) {
-        *dest=*src;
-        dest++;
-        src++;
-        n--;
+    if(SAMEALIGN(s1, s2)) {
+        while(!ALIGNED(s1)) {
+            if(*s1 != *s2 || *s1 == '\0') {
+                return (unsigned char)*s1 - (unsigned char)*s2;
+            }
+            s1++;
+            s2++;
+        }
+        /* Skip all words which are equal and don't end the string */
+        w1 = CWORDPTR(s1);
+        w2 = CWORDPTR(s2);
+        while(*w1 == *w2 && !HASZERO(*w1)) {
+            w1++;
+            w2++;
+        }
+        s1 = (const char *)w1;
+        s2 = (const char *)w2;
+    }
+
+    /* Find the exact difference (or end) bytewise */
+    while(*s1 == *s2 && *s1) {
+        s1++;
+        s2++;
+    }
+
+    return (unsigned char)*s1 - (unsigned char)*s2;
+}
+
+int memcmp(const void *s1, const void *s2, size_t n)
+/*!
+  Compare 'n' bytes of two memory areas. Returns 0 when equal, < 0 when 's1'
+  is less than 's2' and > 0 when 's1' is greater than 's2'
+*/
+{
+    const unsigned char *p1=s1;
+    const unsigned char *p2=s2;
+    const word *w1;
+    const word *w2;
+
+    if(n >= 4 && SAMEALIGN(p1, p2)) {
+        while(!ALIGNED(p1)) {
+            if(*p1 != *p2) {
+                return *p1 - *p2;
+            }
+            p1++;
+            p2++;
+            n--;
+        }
+        /* Skip all equal words; the first different one is compared bytewise below */
+        w1 = CWORDPTR(p1);
+        w2 = CWORDPTR(p2);
+        while(n >= 4 && *w1 == *w2) {
+            w1++;
+            w2++;
+            n -= 4;
+        }
+        p1 = (const unsigned char *)w1;
+        p2 = (const unsigned char *)w2;
     }
 
     while(n) {
-        *dest='\0';
+        if(*p1 != *p2) {
+            return *p1 - *p2;
+        }
+        p1++;
+        p2++;
         n--;
     }
 
-    return begin;
+    return 0;
 }
 
 unsigned int strpos(char *haystack, char *needle)
 /*!
   return numerical location of first occurance of 'needle' in 'haystack',
-  return 0 if not found
+  return STRPOS_NOTFOUND if not found
+*/
+{
+    char *p;
+
+    p = strstr(haystack, needle);
+    if(p == NULL) {
+        return STRPOS_NOTFOUND;
+    }
+    return p-haystack;
+}
+
+char *strstr(const char *haystack, const char *needle)
+/*!
+  Find the first occurance of 'needle' in 'haystack'. Returns a pointer to it,
+  or NULL when not found.
+  This is a Horspool search: the last character of the current window decides
+  how far we can move on, so most of the haystack is never even looked at.
+*/
+{
+    unsigned char shift[STRSTR_SHIFTTABLESIZE];
+    unsigned int needlelen;
+    unsigned int haystacklen;
+    unsigned int last;
+    unsigned int pos;
+    unsigned int i;
+    unsigned char c;
+
+    needlelen = strlen(needle);
+    if(needlelen == 0) {
+        return (char *)haystack;
+    }
+    if(needlelen == 1) {
+        /* No point in building a table for this.. */
+        return strchr(haystack, *needle);
+    }
+    haystacklen = strlen(haystack);
+    if(haystacklen < needlelen) {
+        return NULL;
+    }
+    last = needlelen-1;
+
+    /* Build the shift table. Characters not in the needle let us skip the whole
+       needle length, the others up to their last occurance in the needle (the
+       last character of the needle itsself excluded). Several characters share
+       one table entry; since the shift decreases along the needle, the entry
+       always ends up with the smallest shift of all of them, which is safe. */
+    for(i=0;i<STRSTR_SHIFTTABLESIZE;i++) {
+        shift[i] = needlelen > 255 ? 255 : needlelen;
+    }
+    for(i=0;i<last;i++) {
+        shift[(unsigned char)needle[i] % STRSTR_SHIFTTABLESIZE] = (last-i) > 255 ? 255 : (last-i);
+    }
+
+    pos = 0;
+    while(pos <= haystacklen-needlelen) {
+        c = haystack[pos+last];
+        if(c == (unsigned char)needle[last] && memcmp(haystack+pos, needle, last) == 0) {
+            return (char *)haystack+pos;
+        }
+        pos += shift[c % STRSTR_SHIFTTABLESIZE];
+    }
+
+    return NULL;
+}
+
+char *strchr(const char *s, int c)
+/*!
+  Find the first occurance of character 'c' in 's'. Returns a pointer to it,
+  or NULL when not found. Searching for '\0' returns the end of 's'.
 */
 {
-    unsigned int i=0;
-    unsigned int start=0;
-    char *needlestart=needle;
+    const word *w;
+    word mask;
+
+    c = (unsigned char)c;
 
-    while(haystack[i]) {
-        if(haystack[i] == *needle) {
-            needle++;
+    while(!ALIGNED(s)) {
+        if((unsigned char)*s == c) {
+            return (char *)s;
         }
-        else {
-            /* Restart */
-            needle = needlestart;
-            start = i;
+        if(*s == '\0') {
+            return NULL;
         }
-        /* Did we found him already? */
-        if(*needle == '\0') {
-            return start;
+        s++;
+    }
+
+    /* A word holds 'c' when XOR-ing it with 'c' in each byte gives a zero byte */
+    mask = c * 0x01010101;
+    w = CWORDPTR(s);
+    while(!HASZERO(*w) && !HASZERO(*w ^ mask)) {
+        w++;
+    }
+
+    s = (const char *)w;
+    while((unsigned char)*s != c) {
+        if(*s == '\0') {
+            return NULL;
         }
+        s++;
+    }
+
+    return (char *)s;
+}
+
+char *strrchr(const char *s, int c)
+/*!
+  Find the last occurance of character 'c' in 's'. Returns a pointer to it,
+  or NULL when not found.
+*/
+{
+    const char *found=NULL;
+
+    if((unsigned char)c == '\0') {
+        return (char *)s+strlen(s);
+    }
 
-        i++;
+    /* Hop from occurance to occurance; strchr() takes care of the fast part */
+    while((s = strchr(s, c)) != NULL) {
+        found = s;
+        s++;
     }
+
+    return (char *)found;
+}
+
+unsigned int strnlen(const char *s, size_t maxlen)
+/*!
+  Determine length of given string, but look at no more than 'maxlen' characters
+*/
+{
+    const char *p=s;
+    const word *w;
+
+    while(maxlen && !ALIGNED(p)) {
+        if(*p == '\0') {
+            return p-s;
+        }
+        p++;
+        maxlen--;
+    }
+
+    w = CWORDPTR(p);
+    while(maxlen >= 4 && !HASZERO(*w)) {
+        w++;
+        maxlen -= 4;
+    }
+
+    p = (const char *)w;
+    while(maxlen && *p) {
+        p++;
+        maxlen--;
+    }
+
+    return p-s;
+}
+
+int strncmp(const char *s1, const char *s2, size_t n)
+/*!
+  Compare no more than 'n' characters of two strings. Returns 0 when equal,
+  < 0 when 's1' is less than 's2' and > 0 when 's1' is greater than 's2'
+*/
+{
+    const word *w1;
+    const word *w2;
+
+    if(SAMEALIGN(s1, s2)) {
+        while(n && !ALIGNED(s1)) {
+            if(*s1 != *s2 || *s1 == '\0') {
+                return (unsigned char)*s1 - (unsigned char)*s2;
+            }
+            s1++;
+            s2++;
+            n--;
+        }
+        w1 = CWORDPTR(s1);
+        w2 = CWORDPTR(s2);
+        while(n >= 4 && *w1 == *w2 && !HASZERO(*w1)) {
+            w1++;
+            w2++;
+            n -= 4;
+        }
+        s1 = (const char *)w1;
+        s2 = (const char *)w2;
+    }
+
+    while(n) {
+        if(*s1 != *s2 || *s1 == '\0') {
+            return (unsigned char)*s1 - (unsigned char)*s2;
+        }
+        s1++;
+        s2++;
+        n--;
+    }
+
     return 0;
 }
+
+char *strncat(char *dest, const char *src, size_t n)
+/*!
+  Add no more than 'n' characters of 'src' to 'dest'. The result is always
+  terminated, so 'dest' must have room for n+1 more characters.
+*/
+{
+    char *end;
+
+    end = dest+strlen(dest);
+    n = strnlen(src, n);
+    memcpy(end, src, n);
+    end[n] = '\0';
+
+    return dest;
+}
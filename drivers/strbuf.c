@@ -0,0 +1,153 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    strbuf.c:
+             Length-tracking string builder
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Keeps track of the length of the string, so appending doesn't have to scan
+             the string from the start like strcat() does.
+            -The string in the buffer is always '\0' terminated. What doesn't fit is
+             dropped, and the truncated flag is set. This flag stays set until
+             strbuf_clear() is called, so a whole line can be built and checked once.
+
+*/
+/*!
+\file
+Length-tracking string builder
+*/
+#include <strbuf.h>
+#include <std.h>
+#include <std_string.h>
+#include <print.h>
+#include <err.h>
+#include <stdarg.h>
+
+void strbuf_init(strbuf_t *strbuf, char *buffer, const unsigned int buffersize)
+/*!
+  Initialise the string builder on the given buffer; 'buffersize' includes room
+  for the terminating '\0', and must be at least 1
+*/
+{
+    strbuf->data=buffer;
+    strbuf->size=buffersize;
+    strbuf_clear(strbuf);
+}
+
+void strbuf_clear(strbuf_t *strbuf)
+/*!
+  Empty the string builder, and reset it's truncated flag
+*/
+{
+    strbuf->length=0;
+    strbuf->truncated=FALSE;
+    strbuf->data[0]='\0';
+}
+
+error_t strbuf_addchar(strbuf_t *strbuf, const char c)
+/*!
+  Append a single character. Returns OVERFLOW when it didn't fit
+*/
+{
+    if(strbuf->length+1 >= strbuf->size) {
+        strbuf->truncated=TRUE;
+        return OVERFLOW;
+    }
+    strbuf->data[strbuf->length++]=c;
+    strbuf->data[strbuf->length]='\0';
+
+    return GOOD;
+}
+
+error_t strbuf_addstr(strbuf_t *strbuf, const char *s)
+/*!
+  Append the string 's'. When it does not fit completely, as much as possible
+  is appended and OVERFLOW is returned
+*/
+{
+    unsigned int room = strbuf_getfreebytes(strbuf);
+    unsigned int n;
+    error_t result=GOOD;
+
+    /* Don't look further into 's' than we can store (plus one, to see if it fits) */
+    n=strnlen(s, room+1);
+    if(n > room) {
+        n=room;
+        strbuf->truncated=TRUE;
+        result=OVERFLOW;
+    }
+    memcpy(strbuf->data+strbuf->length, s, n);
+    strbuf->length+=n;
+    strbuf->data[strbuf->length]='\0';
+
+    return result;
+}
+
+error_t strbuf_addnum(strbuf_t *strbuf, const unsigned int num, const unsigned char base)
+/*!
+  Append 'num', converted to a string with the given base (see inttostr()).
+  A number is never appended partially; when it doesn't fit, nothing is
+  appended and OVERFLOW is returned
+*/
+{
+    char c[34];
+    unsigned int n;
+
+    n=inttostr(num, c, base);
+    if(n > strbuf_getfreebytes(strbuf)) {
+        strbuf->truncated=TRUE;
+        return OVERFLOW;
+    }
+    memcpy(strbuf->data+strbuf->length, c, n+1);
+    strbuf->length+=n;
+
+    return GOOD;
+}
+
+static void strbuf_out(unsigned char c, void *arg)
+/*
+  print_format() output for strbuf_addf(); 'arg' is the string builder
+*/
+{
+    strbuf_t *strbuf = arg;
+
+    if(strbuf->length+1 >= strbuf->size) {
+        strbuf->truncated=TRUE;
+    }
+    else {
+        strbuf->data[strbuf->length++]=c;
+    }
+}
+
+error_t strbuf_addf(strbuf_t *strbuf, char *fmt, ...)
+/*!
+  Append a formatted string, using the same format as fprint() and sprint().
+  Whatever doesn't fit is dropped, and OVERFLOW is returned
+*/
+{
+    bool truncated=strbuf->truncated;
+    va_list argpointer;
+
+    strbuf->truncated=FALSE;
+
+    va_start(argpointer, fmt);
+    print_format(strbuf_out, strbuf, fmt, argpointer);
+    va_end(argpointer);
+
+    strbuf->data[strbuf->length]='\0';
+
+    if(strbuf->truncated) {
+        return OVERFLOW;
+    }
+    strbuf->truncated=truncated;
+
+    return GOOD;
+}
@@ -0,0 +1,393 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    swtimer_ARM.c:
+                  Software timers
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Always compiled in ARM mode, so the critical sections are inline and swtimer_start()
+             and swtimer_stop() don't call anything outside RAM with IRQ_IN_RAM.
+            -The timers are kept in a hierarchical timing wheel: SWTIMER_LEVELS levels of
+             SWTIMER_SLOTS slots, where a slot on level L covers SWTIMER_SLOTS^L ticks. A timer
+             goes on the lowest level that reaches it's expiry time, and when the time of a slot
+             on a higher level comes, it's timers move down (cascade). Each level has a bitmap of
+             it's used slots, so the next slot to handle is found with lowestbit() (see std.h)
+             instead of by walking the slots.
+            -The hardware timer counts ticks without ever resetting, and is extended to 64 bits
+             in software. MR0 is set to the next time there's something to do; at the latest
+             SWTIMER_GUARD ticks ahead, so the extension never misses a wrap.
+            -The hardware timer is only started when the software timers are first used
+             (see swtimer_startclock()).
+            -swtimer_wheel is the first tick that has not been handled yet. Every timer in the
+             wheel lies within SWTIMER_SLOTS slots from it, on it's level; that's what makes
+             the slot index of a timer unique.
+
+*/
+/*!
+\file
+Software timers
+*/
+#include <config.h>
+
+#if SWTIMER
+#include <swtimer.h>
+#include <timer.h>
+#include <initcall.h>
+#include <irq.h>
+#include <std.h>
+#include <err.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if SWTIMER_TIMER != 0 && SWTIMER_TIMER != 1
+#error "SWTIMER_TIMER must be 0 or 1"
+#endif
+#if KERNEL && KERNEL_TIMER == SWTIMER_TIMER
+#error "The kernel and the software timers need a different timer"
+#endif
+
+#define __SWTIMER_TIMER(n, name)    timer##n##_##name
+#define SWTIMER_TIMERFN(n, name)    __SWTIMER_TIMER(n, name)
+#define __SWTIMER_REG(timer, reg)   T##timer##reg
+#define SWTIMER_REG(timer, reg)     __SWTIMER_REG(timer, reg)
+#define SWTIMER_IR                  SWTIMER_REG(SWTIMER_TIMER, IR)
+#define SWTIMER_TC                  SWTIMER_REG(SWTIMER_TIMER, TC)
+#define SWTIMER_MR0                 SWTIMER_REG(SWTIMER_TIMER, MR0)
+#define SWTIMER_MCR                 SWTIMER_REG(SWTIMER_TIMER, MCR)
+
+/* The wheel: 6 levels of 32 slots reach 2^30 ticks ahead */
+#define SWTIMER_LEVELS              6
+#define SWTIMER_SLOTS               32
+#define SWTIMER_SLOTBITS            5
+#define SWTIMER_SLOTMASK            (SWTIMER_SLOTS-1)
+
+/* Longest time between two timer interrupts. Small enough that a timer started just
+   before the interrupt (up to SWTIMER_MAXTICKS ahead) still fits in the wheel */
+#define SWTIMER_GUARD               (1<<28)
+
+/* Returned by swtimer_next() when the wheel is empty */
+#define SWTIMER_NEVER               0xFFFFFFFFFFFFFFFFULL
+
+static swtimer_t *swtimer_slots[SWTIMER_LEVELS][SWTIMER_SLOTS];
+static unsigned int swtimer_occupied[SWTIMER_LEVELS];
+static unsigned long long swtimer_wheel;
+
+/* The 64 bit clock, as it was when the hardware timer read swtimer_lasttc */
+static unsigned long long swtimer_clock;
+static unsigned int swtimer_lasttc;
+
+/* What MR0 is set to, and whether the interrupt handler is running */
+static unsigned long long swtimer_deadline;
+static bool swtimer_inhandler;
+
+static IRQFUNC unsigned long long swtimer_sync(void);
+static IRQFUNC void swtimer_add(swtimer_t *timer);
+static IRQFUNC void swtimer_remove(swtimer_t *timer);
+static IRQFUNC unsigned long long swtimer_next(unsigned char *level);
+static IRQFUNC void swtimer_setmatch(unsigned long long time);
+static IRQFUNC void swtimer_intHandler(void);
+
+error_t swtimer_startclock(void)
+/*!
+  Start the hardware timer. This is a lazy initcall, run by the first swtimer_init()
+  or swtimer_now(); until then the timer (and it's interrupt) stays off
+*/
+{
+    interrupt_t status;
+
+    __critical_enter_irq(status);
+
+    SWTIMER_TIMERFN(SWTIMER_TIMER, init)(SWTIMER_GUARD, PCLK_USEC(SWTIMER_USEC)-1, swtimer_intHandler);
+    /* Interrupt on MR0, but keep counting */
+    SWTIMER_MCR = BIT_MCR_MR0_I;
+    swtimer_lasttc = SWTIMER_TC;
+    swtimer_setmatch(SWTIMER_GUARD);
+
+    __critical_exit(status);
+
+    return GOOD;
+}
+LAZYINITCALL(swtimer_startclock);
+
+void swtimer_init(swtimer_t *timer, const SWTIMERFUNCTION function, void *arg)
+/*!
+  Prepare 'timer' to call 'function' with argument 'arg' when it expires. The first
+  call starts the hardware timer, so swtimer_start() doesn't have to
+*/
+{
+    initcall_require(swtimer_startclock);
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->function = function;
+    timer->arg = arg;
+}
+
+error_t swtimer_start(swtimer_t *timer, const unsigned int ticks, const unsigned int period)
+/*!
+  Have 'timer' expire 'ticks' ticks from now, and then every 'period' ticks (0 for once).
+  When it's running already, it's restarted. Returns INVALID when 'ticks' or 'period' is
+  more than SWTIMER_MAXTICKS. May be called from IRQ handlers, and from the timer callbacks
+*/
+{
+    interrupt_t status;
+
+    if(ticks > SWTIMER_MAXTICKS || period > SWTIMER_MAXTICKS) {
+        return INVALID;
+    }
+
+    __critical_enter_irq(status);
+
+    if(timer->pprev != NULL) {
+        swtimer_remove(timer);
+    }
+    timer->expires = swtimer_sync() + ticks;
+    timer->period = period;
+    swtimer_add(timer);
+
+    /* The interrupt handler sets MR0 when it's done */
+    if(!swtimer_inhandler && timer->expires < swtimer_deadline) {
+        swtimer_setmatch(timer->expires);
+    }
+
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+void swtimer_stop(swtimer_t *timer)
+/*!
+  Stop 'timer'; it's callback won't be called anymore. Does nothing when it isn't running.
+  May be called from IRQ handlers, and from the timer callbacks
+*/
+{
+    interrupt_t status;
+
+    __critical_enter_irq(status);
+    if(timer->pprev != NULL) {
+        swtimer_remove(timer);
+    }
+    __critical_exit(status);
+}
+
+bool swtimer_running(const swtimer_t *timer)
+/*!
+  Returns TRUE when 'timer' has been started, and hasn't expired (or is periodic) or
+  been stopped
+*/
+{
+    return timer->pprev != NULL;
+}
+
+unsigned long long swtimer_now(void)
+/*!
+  Return the amount of ticks since swtimer_startclock()
+*/
+{
+    interrupt_t status;
+    unsigned long long now;
+
+    initcall_require(swtimer_startclock);
+
+    __critical_enter_irq(status);
+    now = swtimer_sync();
+    __critical_exit(status);
+
+    return now;
+}
+
+static unsigned long long swtimer_sync(void)
+/*
+  Bring the 64 bit clock up to date, and return it. With IRQ disabled
+*/
+{
+    unsigned int tc = SWTIMER_TC;
+
+    swtimer_clock += tc - swtimer_lasttc;
+    swtimer_lasttc = tc;
+
+    return swtimer_clock;
+}
+
+static void swtimer_add(swtimer_t *timer)
+/*
+  Put 'timer' in the wheel. With IRQ disabled
+*/
+{
+    unsigned long long expires = timer->expires;
+    unsigned int delta;
+    unsigned char level;
+    unsigned char slot;
+
+    /* Expired already; handle it as soon as possible */
+    if(expires < swtimer_wheel) {
+        expires = swtimer_wheel;
+    }
+
+    delta = expires - swtimer_wheel;
+    level = 0;
+    while(level < SWTIMER_LEVELS-1 && delta >= (1U << (SWTIMER_SLOTBITS*(level+1)))) {
+        level++;
+    }
+    slot = (expires >> (SWTIMER_SLOTBITS*level)) & SWTIMER_SLOTMASK;
+
+    timer->level = level;
+    timer->slot = slot;
+    timer->next = swtimer_slots[level][slot];
+    if(timer->next != NULL) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = &swtimer_slots[level][slot];
+    swtimer_slots[level][slot] = timer;
+    swtimer_occupied[level] |= (1U<<slot);
+}
+
+static void swtimer_remove(swtimer_t *timer)
+/*
+  Take 'timer' out of the wheel. With IRQ disabled
+*/
+{
+    *timer->pprev = timer->next;
+    if(timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+    if(swtimer_slots[timer->level][timer->slot] == NULL) {
+        swtimer_occupied[timer->level] &= ~(1U<<timer->slot);
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+static unsigned long long swtimer_next(unsigned char *level)
+/*
+  Return the time of the first used slot, and it's level in 'level'. When a slot on a
+  higher level has the same time, that one comes first, so it's timers are cascaded
+  before the lower level slot is handled. With IRQ disabled
+*/
+{
+    unsigned long long next = SWTIMER_NEVER;
+    unsigned long long first;
+    unsigned long long time;
+    unsigned int occupied;
+    unsigned char shift;
+    unsigned char start;
+    unsigned char l;
+
+    for(l=0;l<SWTIMER_LEVELS;l++) {
+        if(swtimer_occupied[l] == 0) {
+            continue;
+        }
+        shift = SWTIMER_SLOTBITS*l;
+        /* The first slot on this level that's not in the past.. */
+        first = (swtimer_wheel + (1ULL << shift) - 1) >> shift;
+        start = first & SWTIMER_SLOTMASK;
+        /* ..and the used slots, counting from there */
+        occupied = swtimer_occupied[l] >> start;
+        if(start != 0) {
+            occupied |= swtimer_occupied[l] << (SWTIMER_SLOTS - start);
+        }
+        time = (first + lowestbit(occupied)) << shift;
+        if(time <= next) {
+            next = time;
+            *level = l;
+        }
+    }
+
+    return next;
+}
+
+static void swtimer_setmatch(unsigned long long time)
+/*
+  Have the hardware timer interrupt at 'time', or SWTIMER_GUARD ticks from now when
+  that's earlier. When 'time' has passed, it interrupts right away. With IRQ disabled,
+  and the clock synced
+*/
+{
+    if(time > swtimer_clock + SWTIMER_GUARD) {
+        time = swtimer_clock + SWTIMER_GUARD;
+    }
+    swtimer_deadline = time;
+
+    if(time <= swtimer_clock) {
+        SWTIMER_MR0 = swtimer_lasttc + 1;
+    }
+    else {
+        SWTIMER_MR0 = swtimer_lasttc + (unsigned int)(time - swtimer_clock);
+    }
+    /* The counter may have passed it while this was being done */
+    while((int)(SWTIMER_MR0 - SWTIMER_TC) <= 0) {
+        SWTIMER_MR0 = SWTIMER_TC + 1;
+    }
+}
+
+static void swtimer_intHandler(void)
+/*
+  Timer interrupt; call the callbacks of the expired timers, cascade the slots of which
+  the time has come, and set MR0 for the next one
+*/
+{
+    interrupt_t status;
+    unsigned long long now;
+    unsigned long long next;
+    unsigned char level;
+    unsigned char slot;
+    swtimer_t *timer;
+    swtimer_t *list;
+
+    SWTIMER_IR = BIT_IR_MR0;
+
+    __critical_enter_irq(status);
+    swtimer_inhandler = TRUE;
+
+    now = swtimer_sync();
+    while((next = swtimer_next(&level)) <= now) {
+        swtimer_wheel = next;
+        slot = (next >> (SWTIMER_SLOTBITS*level)) & SWTIMER_SLOTMASK;
+
+        if(level != 0) {
+            /* Move it's timers down */
+            list = swtimer_slots[level][slot];
+            swtimer_slots[level][slot] = NULL;
+            swtimer_occupied[level] &= ~(1U<<slot);
+            while(list != NULL) {
+                timer = list;
+                list = timer->next;
+                swtimer_add(timer);
+            }
+            continue;
+        }
+
+        /* Expired. One at a time, as the callbacks may start and stop timers */
+        while((timer = swtimer_slots[0][slot]) != NULL) {
+            swtimer_remove(timer);
+            if(timer->period) {
+                timer->expires += timer->period;
+                if(timer->expires <= now) {
+                    /* Fell behind; skip the periods that were missed */
+                    timer->expires = now + timer->period;
+                }
+                swtimer_add(timer);
+            }
+            __critical_exit(status);
+            timer->function(timer->arg);
+            __critical_enter_irq(status);
+        }
+    }
+    swtimer_wheel = now + 1;
+
+    swtimer_sync();
+    swtimer_setmatch(next);
+
+    swtimer_inhandler = FALSE;
+    __critical_exit(status);
+}
+
+#endif /* SWTIMER */
@@ -0,0 +1,202 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    timebase_ARM.c:
+                   System time
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Always compiled in ARM mode, so the critical section is inline and time_now_ticks()
+             doesn't call anything outside RAM with IRQ_IN_RAM.
+            -The timer runs free, and MR3 (set to 0) interrupts when it wraps. The interrupt adds
+             a full timer period to time_high. A reader that finds the MR3 flag set before the
+             interrupt handled it, knows whether the counter value it read is from before or
+             after the wrap by it's size; it's read just before the flag, so it can't be more
+             than a few ticks after the wrap.
+            -MR3 is used for the wraps, and MR0 by time_waituntil() to wake the CPU from idle
+             mode. MR1 and MR2 are still free (the timer has to keep running free though).
+            -time_waituntil() checks the time with IRQ disabled before going idle, as
+             event_run() does; the VIC wakes the CPU whatever the I bit, so a match that comes
+             in between isn't missed.
+            -time_waituntil() needs the wrap interrupt to get in. time_canwait() tells whether
+             it can: the system time must be started, and the caller must not run with IRQ
+             disabled or from an IRQ or FIQ handler. With IRQ_NESTED, it can't tell a nested
+             handler from a task though; don't wait from one of a higher priority than the
+             timer's.
+
+*/
+/*!
+\file
+System time
+*/
+#include <config.h>
+
+#if TIMEBASE
+#include <timebase.h>
+#include <timer.h>
+#include <initcall.h>
+#include <irq.h>
+#include <power.h>
+#include <err.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if TIMEBASE_TIMER < 0 || TIMEBASE_TIMER > 3
+#error "TIMEBASE_TIMER must be 0 to 3"
+#endif
+#if (TIMEBASE_TIMER == 2 && !defined TIMER2_ENABLED) || (TIMEBASE_TIMER == 3 && !defined TIMER3_ENABLED)
+#error "This MCU doesn't have the timer selected by TIMEBASE_TIMER"
+#endif
+#if (KERNEL && KERNEL_TIMER == TIMEBASE_TIMER) || (SWTIMER && SWTIMER_TIMER == TIMEBASE_TIMER)
+#error "The system time needs a timer of it's own"
+#endif
+#if PCLK % 1000000L != 0 || PCLK_ONE_USEC % TIMEBASE_TICKSPERUSEC != 0
+#error "PCLK must be a multiple of (1<<TIMEBASE_SHIFT) MHz"
+#endif
+
+#define __TIMEBASE_TIMER(n, name)   timer##n##_##name
+#define TIMEBASE_TIMERFN(n, name)   __TIMEBASE_TIMER(n, name)
+#define __TIMEBASE_REG(timer, reg)  T##timer##reg
+#define TIMEBASE_REG(timer, reg)    __TIMEBASE_REG(timer, reg)
+#define TIMEBASE_IR                 TIMEBASE_REG(TIMEBASE_TIMER, IR)
+#define TIMEBASE_TC                 TIMEBASE_REG(TIMEBASE_TIMER, TC)
+#define TIMEBASE_MR0                TIMEBASE_REG(TIMEBASE_TIMER, MR0)
+#define TIMEBASE_MR3                TIMEBASE_REG(TIMEBASE_TIMER, MR3)
+#define TIMEBASE_MCR                TIMEBASE_REG(TIMEBASE_TIMER, MCR)
+#define TIMEBASE_TCR                TIMEBASE_REG(TIMEBASE_TIMER, TCR)
+
+/* Highest counter value, and half of the range */
+#if TIMEBASE_TIMER < 2
+#define TIMEBASE_TOP                0xFFFFFFFFUL
+#else
+#define TIMEBASE_TOP                0xFFFFUL
+#endif
+#define TIMEBASE_HALF               ((TIMEBASE_TOP >> 1) + 1)
+
+/* Shorter waits are not worth going idle for */
+#define TIMEBASE_IDLETICKS          time_us_to_ticks(10)
+
+/* CPSR mode bits, and the modes the interrupt handlers run in */
+#define TIMEBASE_MODEMASK           0x1F
+#define TIMEBASE_IRQMODE            0x12
+#define TIMEBASE_FIQMODE            0x11
+
+/* Ticks counted in the timer periods before this one */
+static volatile unsigned long long time_high;
+/* Set once time_init() started the timer */
+static bool time_started = FALSE;
+
+static IRQFUNC void time_intHandler(void);
+
+error_t time_init(void)
+/*!
+  Start the system time at 0. This is an initcall, so init() takes care of it
+*/
+{
+    TIMEBASE_TIMERFN(TIMEBASE_TIMER, init)(TIMEBASE_TOP, (PCLK_ONE_USEC/TIMEBASE_TICKSPERUSEC)-1, time_intHandler);
+    TIMEBASE_TCR = BIT_TCR_RESET;
+    TIMEBASE_MR3 = 0;
+    TIMEBASE_MCR = BIT_MCR_MR3_I;
+    TIMEBASE_IR = 0xFF;
+    time_high = 0;
+    TIMEBASE_TCR = BIT_TCR_ENABLE;
+    time_started = TRUE;
+
+    return GOOD;
+}
+INITCALL(INITCALL_DRIVER, time_init);
+
+unsigned long long time_now_ticks(void)
+/*!
+  Return the amount of ticks since startup. May be called from IRQ handlers
+*/
+{
+    interrupt_t status;
+    unsigned long long high;
+    unsigned int low;
+
+    __critical_enter_irq(status);
+    high = time_high;
+    low = TIMEBASE_TC;
+    if((TIMEBASE_IR & BIT_IR_MR3) && low < TIMEBASE_HALF) {
+        /* Wrapped, but the interrupt is still pending */
+        high += TIMEBASE_TOP + 1ULL;
+    }
+    __critical_exit(status);
+
+    return high + low;
+}
+
+bool time_canwait(void)
+/*!
+  Returns TRUE when time_waituntil() can be used: the system time runs, and the timer
+  interrupt can get in. Before time_init(), with IRQ disabled and in interrupt handlers,
+  the system time doesn't advance once the timer wraps
+*/
+{
+    unsigned int cpsr;
+
+    if(!time_started || !(TIMEBASE_TCR & BIT_TCR_ENABLE)) {
+        return FALSE;
+    }
+    asm volatile ("mrs     %0, cpsr" : "=r" (cpsr));
+    if((cpsr & IRQ) || (cpsr & TIMEBASE_MODEMASK) == TIMEBASE_IRQMODE || (cpsr & TIMEBASE_MODEMASK) == TIMEBASE_FIQMODE) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void time_waituntil(const unsigned long long until)
+/*!
+  Wait until time_now_ticks() reaches 'until'. With SLEEPWHENWAITING, longer waits are
+  spent in idle mode; shorter ones are a busy loop. Other interrupts are handled
+  meanwhile. Only use it when time_canwait() says so
+*/
+{
+    interrupt_t status;
+    unsigned long long now;
+
+    __critical_enter_irq(status);
+    while((now = time_now_ticks()) < until) {
+        #if SLEEPWHENWAITING
+        if(until - now > TIMEBASE_IDLETICKS) {
+            /* Have MR0 wake the CPU; when it's more than a wrap away, it wakes early,
+               and this just goes idle again */
+            TIMEBASE_MR0 = (unsigned int)until;
+            TIMEBASE_MCR |= BIT_MCR_MR0_I;
+            if(time_now_ticks() < until) {
+                cpu_poweridle();
+            }
+        }
+        #endif
+        /* Let the interrupt handlers in */
+        __critical_exit(status);
+        __critical_enter_irq(status);
+    }
+    TIMEBASE_MCR &= ~BIT_MCR_MR0_I;
+    TIMEBASE_IR = BIT_IR_MR0;
+    __critical_exit(status);
+}
+
+static void time_intHandler(void)
+/*
+  Timer interrupt; the counter wrapped, or time_waituntil() is woken
+*/
+{
+    if(TIMEBASE_IR & BIT_IR_MR0) {
+        TIMEBASE_IR = BIT_IR_MR0;
+    }
+    if(TIMEBASE_IR & BIT_IR_MR3) {
+        TIMEBASE_IR = BIT_IR_MR3;
+        time_high += TIMEBASE_TOP + 1ULL;
+    }
+}
+
+#endif /* TIMEBASE */
@@ -52,4 +52,36 @@ Timer register bit definitions
 #define BIT_MCR_MR3_R   (1 << 10)                                       // Enable Reset of TC upon MR3 match
 #define BIT_MCR_MR3_S   (1 << 11)                                       // Enable Stop of TC upon MR3 match
 
+/* Timer Capture Control Register Bit Definitions; CAPn uses bits 3n to 3n+2 */
+#define BIT_CCR_CAP0RE  (1 << 0)                                        // Capture CR0 on a rising edge of CAPx.0
+#define BIT_CCR_CAP0FE  (1 << 1)                                        // Capture CR0 on a falling edge of CAPx.0
+#define BIT_CCR_CAP0I   (1 << 2)                                        // Interrupt on a CR0 capture
+#define BIT_CCR_CAP1RE  (1 << 3)
+#define BIT_CCR_CAP1FE  (1 << 4)
+#define BIT_CCR_CAP1I   (1 << 5)
+#define BIT_CCR_CAP2RE  (1 << 6)
+#define BIT_CCR_CAP2FE  (1 << 7)
+#define BIT_CCR_CAP2I   (1 << 8)
+#define BIT_CCR_CAP3RE  (1 << 9)
+#define BIT_CCR_CAP3FE  (1 << 10)
+#define BIT_CCR_CAP3I   (1 << 11)
+
+/* External Match Register Bit Definitions */
+#define BIT_EMR_EM0     (1 << 0)                                        // State of MATx.0
+#define BIT_EMR_EM1     (1 << 1)                                        // State of MATx.1
+#define BIT_EMR_EM2     (1 << 2)                                        // State of MATx.2
+#define BIT_EMR_EM3     (1 << 3)                                        // State of MATx.3
+#define EMR_NOTHING     0                                               // What MATx.n does on a MRn match..
+#define EMR_CLEAR       1
+#define EMR_SET         2
+#define EMR_TOGGLE      3
+#define BIT_EMR_EMC(n, action)  ((action) << (4 + 2*(n)))               // ..in the EMCn bits
+
+/* Count Control Register Bit Definitions */
+#define BIT_CTCR_TIMER      (0 << 0)                                    // Count PCLK (through the prescaler)
+#define BIT_CTCR_RISING     (1 << 0)                                    // Count rising edges of the selected CAP input
+#define BIT_CTCR_FALLING    (2 << 0)                                    // Count falling edges
+#define BIT_CTCR_BOTH       (3 << 0)                                    // Count both edges
+#define BIT_CTCR_INPUT(n)   ((n) << 2)                                  // Select CAPx.n as count input
+
 #endif /* TIMER_BITS */
@@ -0,0 +1,222 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    timerpwm.c:
+               Timer PWM driver
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -In PWM mode, a match output is low from the start of the period until TC matches
+             it's MR, and high from there on. So the MR holds the low time, nticks-duty.
+            -The timer match registers aren't shadowed like those of the PWM block (there's no
+             latch register). timerpwm_set() stores the new value, and enables the interrupt of
+             the channel's own match, which writes it. Once TC is past the old match, the output
+             is high for the rest of the period whatever the MR holds, so the new value is used
+             from the next period on. Writing it at the end of the period instead could miss a
+             small new value, as TC is already past it by the time the interrupt handler runs.
+            -When the handler runs so late that the period already ended, TC is below the old
+             match again; the value then waits for the next match.
+            -At 0% duty the MR never matches. The new value is then written on the MR3 (end of
+             period) interrupt; when TC is already past it, the output just stays low for one
+             more period.
+            -A duty cycle that changes faster than once a period only has it's last value used.
+
+*/
+/*!
+\file
+Timer PWM driver
+*/
+#include <timerpwm.h>
+
+#ifdef TIMERPWM_ENABLED
+#if TIMERPWM
+
+#include <types.h>
+#include <timer.h>
+#include <irq.h>
+#include <err.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if TIMERPWM_TIMER < 0 || TIMERPWM_TIMER > 3
+#error "TIMERPWM_TIMER must be 0 to 3"
+#endif
+#if (KERNEL && KERNEL_TIMER == TIMERPWM_TIMER) || (SWTIMER && SWTIMER_TIMER == TIMERPWM_TIMER) || \
+    (TIMEBASE && TIMEBASE_TIMER == TIMERPWM_TIMER) || (CAPTURE && CAPTURE_TIMER == TIMERPWM_TIMER) || \
+    (WAVEFORM && WAVEFORM_TIMER == TIMERPWM_TIMER)
+#error "The timer PWM needs a timer of it's own"
+#endif
+
+#define __TIMERPWM_TIMER(n, name)   timer##n##_##name
+#define TIMERPWM_TIMERFN(n, name)   __TIMERPWM_TIMER(n, name)
+#define __TIMERPWM_REG(timer, reg)  T##timer##reg
+#define TIMERPWM_REG(timer, reg)    __TIMERPWM_REG(timer, reg)
+#define TIMERPWM_IR                 TIMERPWM_REG(TIMERPWM_TIMER, IR)
+#define TIMERPWM_TCR                TIMERPWM_REG(TIMERPWM_TIMER, TCR)
+#define TIMERPWM_TC                 TIMERPWM_REG(TIMERPWM_TIMER, TC)
+#define TIMERPWM_MCR                TIMERPWM_REG(TIMERPWM_TIMER, MCR)
+#define TIMERPWM_MR3                TIMERPWM_REG(TIMERPWM_TIMER, MR3)
+#define TIMERPWM_PWMCON             TIMERPWM_REG(TIMERPWM_TIMER, PWMCON)
+
+#if TIMERPWM_TIMER < 2
+#define TIMERPWM_MAX                0xFFFFFFFFUL
+typedef unsigned long timerpwmreg_t;
+#else
+#define TIMERPWM_MAX                0xFFFFUL
+typedef unsigned short timerpwmreg_t;
+#endif
+
+/* This table is a concession to the fact that the MRn registers can't be indexed */
+static volatile timerpwmreg_t * const MRaddr[TIMERPWM_CHANNELS] = {
+    &TIMERPWM_REG(TIMERPWM_TIMER, MR0),
+    &TIMERPWM_REG(TIMERPWM_TIMER, MR1),
+    &TIMERPWM_REG(TIMERPWM_TIMER, MR2),
+};
+
+/* The period, and the MR values waiting to be written */
+static unsigned int timerpwm_nticks;
+static unsigned int timerpwm_pending[TIMERPWM_CHANNELS];
+static unsigned char timerpwm_update;
+
+/* The interrupt enable bit of a channel's match in MCR */
+#define TIMERPWM_MCR_I(chan)        (BIT_MCR_MR0_I << (3*(chan)))
+
+static IRQFUNC void timerpwm_intHandler(void);
+
+static unsigned int timerpwm_match(unsigned int duty)
+/*
+  The MR value for a high time of 'duty' ticks
+*/
+{
+    if(duty >= timerpwm_nticks) {
+        /* Matches at the start, so high all period */
+        return 0;
+    }
+    if(duty == 0) {
+        /* Never matches, so low all period */
+        return timerpwm_nticks;
+    }
+    return timerpwm_nticks - duty;
+}
+
+error_t timerpwm_set(const unsigned int chan, const unsigned int duty)
+/*!
+  Set duty output for channel
+  The duty value is expected to be [0..nticks] (setting > nticks
+  results in a 100% duty cycle). It's used from the start of the next period
+  (or the one after that, when the current one is almost over).
+*/
+{
+    interrupt_t status;
+
+    if(chan >= TIMERPWM_CHANNELS) {
+        return INVALID;
+    }
+
+    __critical_enter(status);
+    timerpwm_pending[chan] = timerpwm_match(duty);
+    timerpwm_update |= (1<<chan);
+    if(*MRaddr[chan] >= timerpwm_nticks) {
+        /* Never matches, wait for the end of the period */
+        TIMERPWM_MCR |= BIT_MCR_MR3_I;
+    }
+    else {
+        TIMERPWM_MCR |= TIMERPWM_MCR_I(chan);
+    }
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+error_t timerpwm_chan_init(const unsigned int chan, const unsigned int initduty)
+/*!
+  Start up a particular channel.
+  initduty is the initial duty cycle setting (a la timerpwm_set).
+*/
+{
+    if(chan >= TIMERPWM_CHANNELS) {
+        return INVALID;
+    }
+
+    /* Set initial duty cycle, then switch the output to PWM mode */
+    *MRaddr[chan] = timerpwm_match(initduty);
+    TIMERPWM_PWMCON |= (1 << chan);
+
+    return GOOD;
+}
+
+error_t timerpwm_init(const unsigned int nticks, const unsigned int tickcycles)
+/*!
+  Starts the timer
+  nticks is number of divisions in the range
+  tickcycles is the size of the division (pclk cycles)
+  (The PWM period is thus nticks*tickcycles.)
+  Returns INVALID when either is 0, or doesn't fit the timer (16 bit for timer 2 and 3)
+*/
+{
+    /* Since these are decremented, 0 values are anomalous. The prescaler gets tickcycles-1 */
+    if(nticks == 0 || tickcycles == 0 || nticks > TIMERPWM_MAX || tickcycles-1 > TIMERPWM_MAX) {
+        return INVALID;
+    }
+
+    timerpwm_nticks = nticks;
+    timerpwm_update = 0;
+
+    /* Clear TC on a MR3 match, after nticks ticks */
+    TIMERPWM_TIMERFN(TIMERPWM_TIMER, init)(nticks-1, tickcycles-1, timerpwm_intHandler);
+    TIMERPWM_TCR = BIT_TCR_RESET;
+    TIMERPWM_PWMCON = 0;
+    TIMERPWM_MR3 = nticks-1;
+    TIMERPWM_MCR = BIT_MCR_MR3_R;
+    TIMERPWM_TCR = BIT_TCR_ENABLE;
+
+    return GOOD;
+}
+
+static void timerpwm_intHandler(void)
+/*
+  A channel matched, or the period ended; write the new duty cycles that can be written now
+*/
+{
+    unsigned char chan;
+    unsigned char ir;
+    bool atend = FALSE;
+
+    ir = TIMERPWM_IR;
+    TIMERPWM_IR = ir;
+
+    for(chan=0;chan<TIMERPWM_CHANNELS;chan++) {
+        if(!(timerpwm_update & (1<<chan))) {
+            continue;
+        }
+        if(*MRaddr[chan] >= timerpwm_nticks) {
+            /* 0% duty; the output stays low until the new value matches */
+            if(!(ir & BIT_IR_MR3)) {
+                atend = TRUE;
+                continue;
+            }
+        }
+        else if(!(ir & (BIT_IR_MR0 << chan)) || TIMERPWM_TC < *MRaddr[chan]) {
+            /* Not matched yet, or the period ended since; the old match comes (again) */
+            continue;
+        }
+        *MRaddr[chan] = timerpwm_pending[chan];
+        timerpwm_update &= ~(1<<chan);
+        TIMERPWM_MCR &= ~TIMERPWM_MCR_I(chan);
+    }
+    if(!atend) {
+        TIMERPWM_MCR &= ~BIT_MCR_MR3_I;
+    }
+}
+
+#endif /* TIMERPWM */
+#else
+#warning "Driver disabled"
+#endif /* TIMERPWM_ENABLED */
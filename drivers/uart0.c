@@ -84,7 +84,7 @@ static void (* RXintHandler0)(void);
 static void (* RxLineintHandler0)(void);
 static void (* AutoBaudHandler0)(void);
 
-static void uart0_intHandler(void);
+static IRQFUNC void uart0_intHandler(void);
 
 /* Stuff for the interrupt-FiFo buffer */
 #if UART0_INT
@@ -98,7 +98,7 @@ static void (* RxLineintHandler1)(void);
 static void (* FlowControlintHandler1)(void);
 static void (* AutoBaudHandler1)(void);
 
-static void uart1_intHandler(void);
+static IRQFUNC void uart1_intHandler(void);
 
 /* Stuff for the interrupt-FiFo buffer */
 #if UART1_INT
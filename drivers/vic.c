@@ -13,7 +13,9 @@
               version 2 of the License, or (at your option) any later version.
 
     remarks:
-            -
+            -With VIC_DISPATCH, the non-vectored IRQ handler is vic_dispatch(). It finds the
+             pending channels in VICIRQStatus with lowestbit() (see std.h), and calls their
+             handler from vic_channelhandlers[].
 
 */
 /*!
@@ -24,10 +26,26 @@ VIC driver
 #include <types.h>
 #include <irq.h>
 #include <functionname.h>
+#include <std.h>
 #include "exceptions.h"
 #include "registers.h"
 
-#define SLOT_ENABLED    0x20
+#if IRQ_DIRECT
+/* Handlers that were installed without the IRQDIRECT flag. Their VIC slot points
+   to a stub in crt0.S (__irq_slots[]), which calls the handler from this table.
+   The last entry is the handler for non-vectored IRQ's */
+FUNCTION __vic_handlers[PRIO_NONVECTOR+1];
+#endif
+
+#if VIC_DISPATCH
+/* Handlers of the non-vectored channels; a channel only has one when it's bit in
+   vic_nonvectored is set. vic_unhandled is called for the others */
+FUNCTION vic_channelhandlers[VIC_CHANNELS];
+unsigned int vic_nonvectored;
+FUNCTION vic_unhandled = __HaltIrq;
+
+static IRQFUNC void vic_dispatch(void);
+#endif
 
 void vic_init(const FUNCTION defaultIRQhandler)
 /*!
@@ -42,11 +60,21 @@ void vic_init(const FUNCTION defaultIRQhandler)
 
     /* Set non-vectored interrupt-handler. Note that this is already set in the bootcode (crt0.S) to __HaltIRQ() */
     if(defaultIRQhandler!=NULL) {
-        VICDefVectAddr = (unsigned int)defaultIRQhandler;
+        vic_setdefaulthandler(defaultIRQhandler);
     }
+    #if VIC_DISPATCH
+    /* The dispatcher handles them, and calls the default handler when needed */
+    vic_nonvectored = 0;
+    __vic_setdefvectaddr(vic_dispatch);
+    #endif
     /* Fill vectors */
     for(i=0;i<16;i++) {
+        #if IRQ_DIRECT
+        __vic_handlers[i] = __HaltVICerr;                   /* Through the stub, as it may be Thumb code */
+        VICVectAddrArray[i] = __irq_slots[i];
+        #else
         VICVectAddrArray[i] = (unsigned int)__HaltVICerr;   /* Set vector address to a sensible default */
+        #endif
         VICVectCntlArray[i] = 0;                            /* And de-assign the channel */
     }
     /* disable all interrupt sources */
@@ -60,29 +88,57 @@ void vic_setup(const unsigned char channel, const unsigned char IRQorFIQ, const
   Install a new VIC handler.
   When installing a FIQ (thus 'IRQorFIQ' == FIQ), the 'priority' and 'handler' arguments are ignored since FIQ's cannot be vectored.
   If using a priority >= PRIO_NONVECTOR, the 'handler' argument is ignored; this IRQ will end up in the default, unvectored handler.
+  With VIC_DISPATCH enabled (see config.h), 'handler' is then called by the dispatcher instead.
+  With IRQ_DIRECT enabled (see config.h), 'IRQorFIQ' may be IRQ | IRQDIRECT, to have the IRQ vector jump
+  straight to 'handler'. It must then be declared with IRQDIRECTFUNC (see types.h).
   Note: this is a 'dangerous' function. Using it the wrong way will most likely cause your program to crash.
 */
 {
-    __store_interrupts(&__interrupt_status);
+    interrupt_t status;
+
+    __critical_enter(status);
 
-    if (IRQorFIQ == IRQ) {
+    if (IRQorFIQ & IRQ) {
         VICIntSelect &=~ (1<<channel);                  /* IRQ */
 
         /* If this is a vectored interrupt, set it's vector.
            (Jup, only IRQ's can be vectored) */
         if(priority < PRIO_NONVECTOR) {
+            #if IRQ_DIRECT
+            if(!(IRQorFIQ & IRQDIRECT)) {
+                /* A normal handler; it's called from the stub for this slot */
+                __vic_handlers[priority] = handler;
+                VICVectAddrArray[priority] = __irq_slots[priority];
+            }
+            else {
+                VICVectAddrArray[priority] = (unsigned int)handler;
+            }
+            #else
             VICVectAddrArray[priority] = (unsigned int)handler;  /* interrupt-handler */
+            #endif
             VICVectCntlArray[priority] = SLOT_ENABLED | channel; /* slot is enabled, and using the given source */
+            #if VIC_DISPATCH
+            vic_nonvectored &=~ (1<<channel);
+            #endif
         }
+        #if VIC_DISPATCH
+        else if(handler != NULL) {
+            vic_channelhandlers[channel] = handler;     /* called from vic_dispatch() */
+            vic_nonvectored |= (1<<channel);
+        }
+        #endif
     }
     else {
         VICIntSelect |=  (1<<channel);                  /* FIQ */
+        #if VIC_DISPATCH
+        vic_nonvectored &=~ (1<<channel);
+        #endif
     }
     VICIntEnable = (1<<channel);                        /* interrupt source enabled */
 
     VICVectAddr = 0xFF;                                 /* write changes */
 
-    __restore_interrupts(&__interrupt_status);
+    __critical_exit(status);
 }
 
 void vic_disablechannel(const unsigned int channel)
@@ -90,10 +146,12 @@ void vic_disablechannel(const unsigned int channel)
   Disable one single VIC-channel
 */
 {
-    __store_interrupts(&__interrupt_status);
+    interrupt_t status;
+
+    __critical_enter(status);
     VICIntEnClr |= (1<<channel);
     VICVectAddr = 0xFF;
-    __restore_interrupts(&__interrupt_status);
+    __critical_exit(status);
 }
 
 void vic_enablechannel(const unsigned int channel)
@@ -101,10 +159,12 @@ void vic_enablechannel(const unsigned int channel)
   Enable one single VIC-channel
 */
 {
-    __store_interrupts(&__interrupt_status);
+    interrupt_t status;
+
+    __critical_enter(status);
     VICIntEnable = (1<<channel);
     VICVectAddr = 0xFF;
-    __restore_interrupts(&__interrupt_status);
+    __critical_exit(status);
 }
 
 unsigned char vic_gethighestfreepriority(void)
@@ -112,11 +172,20 @@ unsigned char vic_gethighestfreepriority(void)
   Return the highest free slot in the VIC, or PRIO_NONVECTOR if
   all slots are in use
 */
+{
+    return vic_getfreepriority(PRIO_MAX);
+}
+
+unsigned char vic_getfreepriority(const unsigned char first)
+/*!
+  Return the highest free slot in the VIC, starting at slot 'first', or PRIO_NONVECTOR
+  if all slots from there on are in use
+*/
 {
     unsigned char vector;
 
     /* Loop through the vector table until we find a free one */
-    for(vector=PRIO_MAX;vector<=PRIO_MIN;vector++) {
+    for(vector=first;vector<=PRIO_MIN;vector++) {
         if(!(VICVectCntlArray[vector] & SLOT_ENABLED)) {
             return vector;
         }
@@ -124,6 +193,35 @@ unsigned char vic_gethighestfreepriority(void)
     return PRIO_NONVECTOR;
 }
 
+unsigned char vic_setupclass(const unsigned char channel, const unsigned char prioclass, const FUNCTION handler)
+/*!
+  Install IRQ 'handler' for the given channel, in the first free slot of the given priority
+  class (one of the PRIOCLASS_* defines). When the class is full, the first free slot after
+  it is used. When there's none at all the IRQ is non-vectored; with VIC_DISPATCH disabled it's
+  then not installed. Returns the slot used, or PRIO_NONVECTOR.
+  Note that the drivers use the fixed priorities from vic.h, and take their slot whether it's
+  in use or not. So set them up first.
+*/
+{
+    interrupt_t status;
+    unsigned char priority;
+
+    __critical_enter(status);
+
+    priority = vic_getfreepriority(prioclass);
+    #if !VIC_DISPATCH
+    if(priority == PRIO_NONVECTOR) {
+        __critical_exit(status);
+        return PRIO_NONVECTOR;
+    }
+    #endif
+    vic_setup(channel, IRQ, priority, handler);
+
+    __critical_exit(status);
+
+    return priority;
+}
+
 unsigned char vic_getpriority(const unsigned char channel)
 /*!
   Return the priority of the given channel. Return PRIO_NONVECTOR when no vector is assigned to the given channel.
@@ -140,3 +238,58 @@ unsigned char vic_getpriority(const unsigned char channel)
     }
     return PRIO_NONVECTOR;
 }
+
+unsigned int vic_gethandler(const unsigned char priority)
+/*!
+  Return the address of the handler in the given slot, or of the non-vectored handler when
+  'priority' is PRIO_NONVECTOR. With IRQ_DIRECT, this is the handler that's called, not the
+  stub in crt0.S that calls it.
+*/
+{
+    unsigned int address;
+
+    if(priority < PRIO_NONVECTOR) {
+        address=VICVectAddrArray[priority];
+    }
+    else {
+        address=VICDefVectAddr;
+    }
+
+    #if IRQ_DIRECT
+    {
+        unsigned char i;
+
+        for(i=0;i<=PRIO_NONVECTOR;i++) {
+            if(address == __irq_slots[i]) {
+                return (unsigned int)__vic_handlers[i];
+            }
+        }
+    }
+    #endif
+
+    return address;
+}
+
+#if VIC_DISPATCH
+static void vic_dispatch(void)
+/*
+  The non-vectored IRQ handler. Calls the handler of each pending non-vectored channel,
+  lowest channel first, as the VIC would
+*/
+{
+    unsigned int pending;
+
+    pending = VICIRQStatus & vic_nonvectored;
+    if(pending == 0) {
+        /* A channel without a handler */
+        vic_unhandled();
+        return;
+    }
+
+    do {
+        vic_channelhandlers[lowestbit(pending)]();
+        /* Clear the lowest bit */
+        pending &= pending - 1;
+    } while(pending);
+}
+#endif /* VIC_DISPATCH */
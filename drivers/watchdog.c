@@ -100,10 +100,12 @@ void watchdog_clear(void)
   Clear the watchdog counter
 */
 {
-    __store_interrupts(&__interrupt_status);
+    interrupt_t status;
+
+    __critical_enter(status);
     WDFEED = 0xAA;
     WDFEED = 0x55;
-    __restore_interrupts(&__interrupt_status);
+    __critical_exit(status);
 }
 
 void watchdog_trigger(void)
@@ -0,0 +1,215 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    waveform.c:
+               Match output waveforms
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -See waveform.h for how to use this.
+            -Square waves: MR3 resets the counter every half period, and every used channel
+             toggles it's output on it's own match register.
+            -A pulse: the output is set in EMR, after which the timer is started, and stops on
+             the channel's match while clearing the output. So the width is exact, apart from
+             the few PCLK cycles between the two register writes.
+
+*/
+/*!
+\file
+Match output waveforms
+*/
+#include <config.h>
+
+#if WAVEFORM
+#include <waveform.h>
+#include <timer.h>
+#include <irq.h>
+#include <err.h>
+#include "registers.h"
+#include "timer_bits.h"
+
+#if WAVEFORM_TIMER < 0 || WAVEFORM_TIMER > 3
+#error "WAVEFORM_TIMER must be 0 to 3"
+#endif
+#if (WAVEFORM_TIMER == 2 && !defined TIMER2_ENABLED) || (WAVEFORM_TIMER == 3 && !defined TIMER3_ENABLED)
+#error "This MCU doesn't have the timer selected by WAVEFORM_TIMER"
+#endif
+#if (KERNEL && KERNEL_TIMER == WAVEFORM_TIMER) || (SWTIMER && SWTIMER_TIMER == WAVEFORM_TIMER) || \
+    (TIMEBASE && TIMEBASE_TIMER == WAVEFORM_TIMER) || (CAPTURE && CAPTURE_TIMER == WAVEFORM_TIMER)
+#error "The waveforms need a timer of their own"
+#endif
+
+#define __WAVEFORM_TIMER(n, name)   timer##n##_##name
+#define WAVEFORM_TIMERFN(n, name)   __WAVEFORM_TIMER(n, name)
+#define __WAVEFORM_REG(timer, reg)  T##timer##reg
+#define WAVEFORM_REG(timer, reg)    __WAVEFORM_REG(timer, reg)
+#define WAVEFORM_TCR                WAVEFORM_REG(WAVEFORM_TIMER, TCR)
+#define WAVEFORM_MCR                WAVEFORM_REG(WAVEFORM_TIMER, MCR)
+#define WAVEFORM_EMR                WAVEFORM_REG(WAVEFORM_TIMER, EMR)
+#define WAVEFORM_MR3                WAVEFORM_REG(WAVEFORM_TIMER, MR3)
+
+#if WAVEFORM_TIMER < 2
+#define WAVEFORM_MAX                0xFFFFFFFFUL
+typedef unsigned long waveformreg_t;
+#else
+#define WAVEFORM_MAX                0xFFFFUL
+typedef unsigned short waveformreg_t;
+#endif
+
+/* The match registers */
+static volatile waveformreg_t * const waveform_registers[WAVEFORM_CHANNELS] = {
+    &WAVEFORM_REG(WAVEFORM_TIMER, MR0),
+    &WAVEFORM_REG(WAVEFORM_TIMER, MR1),
+    &WAVEFORM_REG(WAVEFORM_TIMER, MR2),
+    &WAVEFORM_REG(WAVEFORM_TIMER, MR3),
+};
+
+/* Channels used for the square waves, and their phase */
+static unsigned char waveform_used;
+static unsigned int waveform_phase[WAVEFORM_CHANNELS-1];
+
+error_t waveform_init(const unsigned int prescaler)
+/*!
+  Prepare the WAVEFORM_TIMER, counting PCLK/('prescaler'+1). No channels are used, and
+  all outputs are low
+*/
+{
+    WAVEFORM_TIMERFN(WAVEFORM_TIMER, init)(WAVEFORM_MAX, prescaler, NULL);
+    WAVEFORM_TCR = BIT_TCR_RESET;
+    WAVEFORM_MCR = 0;
+    WAVEFORM_EMR = 0;
+    waveform_used = 0;
+
+    return GOOD;
+}
+
+error_t waveform_channel(const unsigned char channel, const unsigned int phase)
+/*!
+  Use 'channel' (0 to 2) for the square waves; it toggles 'phase' ticks into every half
+  period. Takes effect on the next waveform_square(). Returns INVALID for a bad channel
+*/
+{
+    if(channel >= WAVEFORM_CHANNELS-1) {
+        return INVALID;
+    }
+    waveform_phase[channel] = phase;
+    waveform_used |= (1<<channel);
+
+    return GOOD;
+}
+
+error_t waveform_square(const unsigned int halfperiod)
+/*!
+  (Re)start the square waves on the channels set up with waveform_channel(), all low at
+  the start, with a period of twice 'halfperiod' ticks. Returns INVALID when 'halfperiod'
+  doesn't fit the timer, or is shorter than a channel's phase
+*/
+{
+    unsigned int emr = 0;
+    unsigned char channel;
+
+    if(halfperiod == 0 || halfperiod-1 > WAVEFORM_MAX) {
+        return INVALID;
+    }
+    for(channel=0;channel<WAVEFORM_CHANNELS-1;channel++) {
+        if((waveform_used & (1<<channel)) && waveform_phase[channel] >= halfperiod) {
+            return INVALID;
+        }
+    }
+
+    WAVEFORM_TCR = BIT_TCR_RESET;
+    WAVEFORM_MCR = BIT_MCR_MR3_R;
+    WAVEFORM_MR3 = halfperiod-1;
+    for(channel=0;channel<WAVEFORM_CHANNELS-1;channel++) {
+        if(waveform_used & (1<<channel)) {
+            *waveform_registers[channel] = waveform_phase[channel];
+            emr |= BIT_EMR_EMC(channel, EMR_TOGGLE);
+        }
+    }
+    WAVEFORM_EMR = emr;
+    WAVEFORM_TCR = BIT_TCR_ENABLE;
+
+    return GOOD;
+}
+
+error_t waveform_pulse(const unsigned char channel, const unsigned int width)
+/*!
+  Make a high pulse of 'width' ticks on 'channel' (0 to 3). The timer ends it, so this
+  returns right away; waveform_busy() tells when it's done. Stops the square waves (the
+  other outputs keep their level). Returns INVALID for a bad channel or width, and BUSY
+  when a pulse is still going on
+*/
+{
+    interrupt_t status;
+
+    if(channel >= WAVEFORM_CHANNELS || width == 0 || width > WAVEFORM_MAX) {
+        return INVALID;
+    }
+    /* Running, but not for square waves */
+    if(waveform_busy() && WAVEFORM_MCR != BIT_MCR_MR3_R) {
+        return BUSY;
+    }
+
+    WAVEFORM_TCR = BIT_TCR_RESET;
+    WAVEFORM_MCR = (BIT_MCR_MR0_S << (3*channel));
+    *waveform_registers[channel] = width;
+
+    /* Keep the two writes together, so the width is right */
+    __critical_enter(status);
+    WAVEFORM_EMR = (WAVEFORM_EMR & (BIT_EMR_EM0 | BIT_EMR_EM1 | BIT_EMR_EM2 | BIT_EMR_EM3)) |
+                   (BIT_EMR_EM0 << channel) | BIT_EMR_EMC(channel, EMR_CLEAR);
+    WAVEFORM_TCR = BIT_TCR_ENABLE;
+    __critical_exit(status);
+
+    return GOOD;
+}
+
+bool waveform_busy(void)
+/*!
+  Returns TRUE while the timer runs: during a pulse, or when making square waves
+*/
+{
+    return (WAVEFORM_TCR & BIT_TCR_ENABLE) != 0;
+}
+
+void waveform_stop(void)
+/*!
+  Stop the timer; the outputs keep their level
+*/
+{
+    WAVEFORM_TCR = 0;
+    WAVEFORM_MCR = 0;
+    WAVEFORM_EMR &= (BIT_EMR_EM0 | BIT_EMR_EM1 | BIT_EMR_EM2 | BIT_EMR_EM3);
+}
+
+error_t waveform_set(const unsigned char channel, const bool level)
+/*!
+  Set the output of 'channel' to 'level'. Returns INVALID for a bad channel, and BUSY
+  while the timer runs
+*/
+{
+    if(channel >= WAVEFORM_CHANNELS) {
+        return INVALID;
+    }
+    if(waveform_busy()) {
+        return BUSY;
+    }
+
+    if(level) {
+        WAVEFORM_EMR |= (BIT_EMR_EM0 << channel);
+    }
+    else {
+        WAVEFORM_EMR &= ~(BIT_EMR_EM0 << channel);
+    }
+
+    return GOOD;
+}
+
+#endif /* WAVEFORM */
@@ -76,7 +76,7 @@ Analog to digital converter function definitions
 #define ADC0_ENABLED
 error_t adc0_init(const unsigned char channel);
 unsigned short adc0_get(const unsigned char channel, const unsigned char speed);
-void adc0_startburst(const unsigned char channel, const unsigned int trigger, const unsigned char edge, const unsigned char speed, const unsigned char clocks, const FUNCTION handler);
+error_t adc0_startburst(const unsigned char channel, const unsigned int trigger, const unsigned char edge, const unsigned char speed, const unsigned char clocks, const FUNCTION handler);
 void adc0_stopburst(void);
 /* Following macro's are here for ADC channels used in burst mode */
 /*! Return status of ADC0; bits are defined in adc.h (ADC_DONE* and ADC_OVERRUN*) */
@@ -96,7 +96,7 @@ void adc0_stopburst(void);
 #define ADC1_ENABLED
 error_t adc1_init(const unsigned char channel);
 unsigned short adc1_get(const unsigned char channel, const unsigned char speed);
-void adc1_startburst(const unsigned char channel, const unsigned int trigger, const unsigned char edge, const unsigned char speed, const unsigned char clocks, const FUNCTION handler);
+error_t adc1_startburst(const unsigned char channel, const unsigned int trigger, const unsigned char edge, const unsigned char speed, const unsigned char clocks, const FUNCTION handler);
 void adc1_stopburst(void);
 /* Following macro's are here for ADC channels used in burst mode */
 /*! Return status of ADC1; bits are defined in adc.h (ADC_DONE* and ADC_OVERRUN*) */
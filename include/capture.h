@@ -0,0 +1,75 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    capture.h:
+              Timer capture driver, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when CAPTURE is enabled (see config.h).
+            -The timer hardware copies it's counter into a capture register on the edge, so the
+             time stamps don't depend on interrupt latency. The interrupt handler only moves
+             them into the channel's ringbuffer, and keeps the last period and high time.
+            -Timer 0 and 1 have 4 capture inputs, timer 2 and 3 (LPC2101/2/3) have 3, and are
+             16 bit. Select the CAP function of the pins in PINSEL yourself; which pin that is
+             differs per MCU.
+            -With CAPTURE_BOTH, the driver reads the level of the input pin to know which edge
+             each time stamp belongs to, so capture_start() needs the pin number then. When a
+             pulse is shorter than the interrupt latency, only the edge that ends it is kept.
+             A missed falling edge only loses the high time of that period. After a missed
+             rising edge the measurement starts over, so it takes two more rising edges until
+             capture_period() is updated again.
+            -In counter mode (capture_counter()) the timer counts edges on one of it's capture
+             inputs, without any interrupt; read the count with capture_count(). The time stamps
+             of the other channels are then in counted edges instead of time.
+
+*/
+/*!
+\file
+Timer capture driver, the definitions
+*/
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+/*! Edges to capture */
+#define CAPTURE_RISING          (1<<0)
+#define CAPTURE_FALLING         (1<<1)
+#define CAPTURE_BOTH            (CAPTURE_RISING | CAPTURE_FALLING)
+
+/*! Capture channels of the CAPTURE_TIMER */
+#if CAPTURE_TIMER < 2
+#define CAPTURE_CHANNELS        4
+#else
+#define CAPTURE_CHANNELS        3
+#endif
+
+/*! One time stamp, as stored in the ringbuffer */
+typedef struct captureevent {
+    unsigned int time;              /* Timer value at the edge */
+    unsigned char edge;             /* CAPTURE_RISING or CAPTURE_FALLING */
+} captureevent_t;
+
+error_t capture_init(const unsigned int prescaler);
+error_t capture_counter(const unsigned char input, const unsigned char edges);
+unsigned int capture_count(void);
+error_t capture_start(const unsigned char channel, const unsigned char edges, const unsigned char pin, captureevent_t *buffer, const unsigned int length);
+error_t capture_stop(const unsigned char channel);
+unsigned int capture_read(const unsigned char channel, captureevent_t *events, const unsigned int count);
+unsigned int capture_lost(const unsigned char channel);
+unsigned int capture_period(const unsigned char channel);
+unsigned int capture_frequency(const unsigned char channel);
+unsigned int capture_duty(const unsigned char channel);
+
+#endif /* CAPTURE_H */
@@ -0,0 +1,80 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    coroutine.h:
+                Stackful coroutines, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -A coroutine is a function with it's own stack, which can stop halfway with
+             coroutine_yield(), and continue where it was with the next coroutine_resume(). So a
+             driver sequence (an I2C transaction, erasing and writing flash) can be written as
+             one function, waiting for the hardware with coroutine_waitfor() instead of a busy
+             loop, while the rest of the program goes on.
+            -Coroutines are resumed from normal code, typically an event handler (see event.h)
+             posted by the interrupt handler of the hardware it's waiting for, or on every
+             round of the main loop. Never from an interrupt handler.
+            -A coroutine may resume another one; yield then returns to the one that resumed it.
+            -Coroutines and their stacks are defined with COROUTINE(), so the linker allocates
+             them. The stack is filled with COROUTINE_STACKFILL on coroutine_start(), for
+             coroutine_stackunused(). Everything the coroutine calls runs on it's stack too.
+
+*/
+/*!
+\file
+Stackful coroutines, the definitions
+*/
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+/*! Unused stack space is filled with this */
+#define COROUTINE_STACKFILL     0xA5A5A5A5
+
+typedef void (* COROUTINEFUNCTION)(void *arg);
+
+typedef struct coroutine {
+    unsigned int *sp;               /* Saved stackpointer, while it's not running */
+    unsigned int *callersp;         /* Saved stackpointer of the one that resumed it */
+    struct coroutine *caller;       /* The coroutine that resumed it, or NULL */
+    unsigned int *stack;            /* Lowest address of the stack.. */
+    unsigned int stacksize;         /* ..and it's size, in bytes */
+    COROUTINEFUNCTION function;
+    void *arg;
+    bool running;                   /* Started, and not returned yet */
+} coroutine_t;
+
+/*! Define coroutine 'name' (a coroutine_t), with a stack of 'stacksize' bytes */
+#define COROUTINE(name, stacksize) \
+    static unsigned int name##_stack[((stacksize)+7)/8*2] __attribute__ ((aligned (8))); \
+    coroutine_t name = { NULL, NULL, NULL, name##_stack, sizeof(name##_stack), NULL, NULL, FALSE }
+
+/*! Yield until 'condition' is true. Only in a coroutine */
+#define coroutine_waitfor(condition)    do { \
+                                            while(!(condition)) { \
+                                                coroutine_yield(); \
+                                            } \
+                                        } while(0)
+
+error_t coroutine_start(coroutine_t *coroutine, const COROUTINEFUNCTION function, void *arg);
+error_t coroutine_resume(coroutine_t *coroutine);
+void coroutine_yield(void);
+coroutine_t *coroutine_current(void);
+unsigned int coroutine_stackunused(const coroutine_t *coroutine);
+
+/* The register swap, see coroutine_ARM.S */
+extern void __coroutine_swap(unsigned int **savesp, unsigned int *loadsp);
+extern void __coroutine_entry(void);
+
+#endif /* COROUTINE_H */
@@ -26,6 +26,7 @@ Versatile debug function(s), the definitions
 #include "../config-debug.h"
 
 #include <config.h>
+#include <types.h>
 
 /* These define the debug levels. No need to change it, unless
    you like to mess things up.. */
@@ -35,11 +36,78 @@ Versatile debug function(s), the definitions
 #define D_INFO          3
 #define D_XINFO         4
 
-#if ! DEBUG
+/* Debug modules. Each module has it's own runtime debug level (see
+   debug_setlevel()), so the verbosity of one subsystem can be raised
+   without flooding the debug console with the output of all others.
+   Project code can use DMOD_USER up to DMOD_USER + DEBUG_USERMODULES - 1
+   (see config-debug.h). */
+#define DMOD_SYSTEM     0
+#define DMOD_RINGBUFFER 1
+#define DMOD_UART       2
+#define DMOD_ADC        3
+#define DMOD_TIMER      4
+#define DMOD_VIC        5
+#define DMOD_PLL        6
+#define DMOD_I2C        7
+#define DMOD_SPI        8
+#define DMOD_IAP        9
+#define DMOD_USER       10
+/*! Total amount of debug modules */
+#define DMOD_COUNT      (DMOD_USER + DEBUG_USERMODULES)
 
-/* Debug is disabled, so only provide an empty macro to satisfy the compiler */
+#if DEBUG
+
+/*! The runtime debug level of each module. Use debug_setlevel() to change these */
+extern unsigned char debug_levels[DMOD_COUNT];
+
+error_t debug_setlevel(const unsigned char module, const unsigned char level);
+unsigned char debug_getlevel(const unsigned char module);
+void debug_setlevels(const unsigned char level);
+void debug_printlevels(void);
+
+/*! Leveled debug output. The message is printed when 'level' is not above the
+    DEBUG level set in config.h, *and* not above the runtime level of 'module'.
+    When 'level' is a constant (it usually is) the first test is done at compile
+    time, so anything above the DEBUG level doesn't end up in the binary at all. */
+#define dlog(module, level, ...)    do { \
+                                        if((level) <= DEBUG && (level) <= debug_levels[module]) { \
+                                            dprint(__VA_ARGS__); \
+                                        } \
+                                    } while(0)
+
+#else
+
+/* Debug is disabled, so only provide empty macro's to satisfy the compiler */
 #define dprint(args...)
+#define dlog(module, level, args...)
+#define debug_setlevel(module, level)   GOOD
+#define debug_getlevel(module)          D_NONE
+#define debug_setlevels(level)
+#define debug_printlevels()
 
 #endif /* DEBUG */
 
+/* Shortcuts for each debug level. Levels above the DEBUG level set in config.h
+   are removed by the preprocessor, arguments and all. */
+#if DEBUG >= D_ERROR
+#define derror(module, ...)     dlog(module, D_ERROR, __VA_ARGS__)
+#else
+#define derror(module, ...)
+#endif
+#if DEBUG >= D_WARN
+#define dwarn(module, ...)      dlog(module, D_WARN, __VA_ARGS__)
+#else
+#define dwarn(module, ...)
+#endif
+#if DEBUG >= D_INFO
+#define dinfo(module, ...)      dlog(module, D_INFO, __VA_ARGS__)
+#else
+#define dinfo(module, ...)
+#endif
+#if DEBUG >= D_XINFO
+#define dxinfo(module, ...)     dlog(module, D_XINFO, __VA_ARGS__)
+#else
+#define dxinfo(module, ...)
+#endif
+
 #endif /* DEBUG_H */
@@ -0,0 +1,62 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    defer.h:
+            Deferred work queue, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Interrupt handlers (and callbacks called from them) can hand work off with
+             defer_post(); it's then done outside the handler, so IRQ's aren't blocked by it.
+            -With DEFER_SOFTINT 0 (see config.h), the main loop must call defer_run() to get
+             the work done. Otherwise it's done from a software triggered IRQ with the lowest
+             priority (PRIO_DEFER, see vic.h), with interrupts enabled; defer_run() is then
+             not available.
+            -There's a queue for each priority, of DEFER_QUEUELENGTH items. Work with a higher
+             priority is always done first; work with the same priority in the order it was
+             posted.
+            -defer_post() can be called from IRQ handlers and normal code, but not from a FIQ
+             handler.
+
+*/
+/*!
+\file
+Deferred work queue, the definitions
+*/
+#ifndef DEFER_H
+#define DEFER_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+/*! Work priorities */
+#define DEFER_HIGH          0
+#define DEFER_NORMAL        1
+#define DEFER_LOW           2
+#define DEFER_PRIORITIES    3
+
+typedef void (* DEFERFUNCTION)(void *arg);
+
+typedef struct deferwork {
+    DEFERFUNCTION function;         /* Function to call.. */
+    void *arg;                      /* ..and it's argument */
+} deferwork_t;
+
+#if DEFER_SOFTINT
+error_t defer_init(void);
+#else
+unsigned int defer_run(void);
+#endif
+IRQFUNC error_t defer_post(const unsigned char priority, const DEFERFUNCTION function, void *arg);
+bool defer_pending(void);
+
+#endif /* DEFER_H */
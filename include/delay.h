@@ -23,6 +23,7 @@ Simple delay functions, the definitions
 /* Include global configuration */
 #include <config.h>
 
+/* Calibrated busy loops */
 #if __FOSC == 10000
 /* The following values have been calulated and tested with an oscilloscope,
    measuring the timing of a pulse generated on an I/O pin. They are more or less
@@ -40,10 +41,18 @@ Simple delay functions, the definitions
 #error "Don't know the right delay values for the selected __FOSC value!"
 #endif
 
+void delay(volatile unsigned int time, volatile const unsigned int unit);
+
+#if TIMEBASE
+/* Timed with the system time (see timebase.h), or the busy loops when that can't be
+   used (see delay.c) */
+void delay_us(const unsigned int time);
+void delay_ms(const unsigned int time);
+void delay_s(const unsigned int time);
+#else
 #define delay_s(t)      delay(t, DELAY_S)
 #define delay_us(t)     delay(t, DELAY_US)
 #define delay_ms(t)     delay(t, DELAY_MS)
-
-void delay(volatile unsigned int time, volatile const unsigned int unit);
+#endif /* TIMEBASE */
 
 #endif /* DELAY_H */
@@ -0,0 +1,54 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    event.h:
+            Event loop, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Instead of a main loop that polls flags, register a handler for each event with
+             event_register(), and call event_loop() (or event_run() from your own loop).
+             Interrupt handlers call event_post() to have the handler called.
+            -An event that is posted again before it's handler ran is handled once.
+            -Events with a lower number are handled first.
+            -With DEFER_SOFTINT 0 (see config.h), event_run() also does the work queued with
+             defer_post() (see defer.h).
+            -When there's nothing to do, event_run() puts the CPU in idle mode (with
+             SLEEPWHENWAITING, see config.h) until the next interrupt.
+
+*/
+/*!
+\file
+Event loop, the definitions
+*/
+#ifndef EVENT_H
+#define EVENT_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+#include <gcc.h>
+
+/*! Amount of events */
+#define EVENTS              32
+
+typedef void (* EVENTFUNCTION)(const unsigned char event);
+
+error_t event_register(const unsigned char event, const EVENTFUNCTION handler);
+IRQFUNC error_t event_post(const unsigned char event);
+void event_run(void);
+void event_loop(void) __noreturn;
+#if EVENT_IDLESTATS
+error_t event_startstats(void);
+unsigned char event_idlepercent(void);
+#endif
+
+#endif /* EVENT_H */
@@ -0,0 +1,83 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    fiq.h:
+          FIQ fast path, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when FIQ_HANDLER is set (see config.h).
+            -One interrupt source is handled as FIQ. Since it's the only one, the handler
+             doesn't have to ask the VIC what fired; it's called straight from the FIQ vector.
+            -FIQ mode has it's own (banked) r8-r12. Nothing else uses them, so they keep their
+             value between FIQ's. Preload them with fiq_setregisters() before enabling the
+             FIQ, and read them back with fiq_getregisters(). For example, to sample the ADC
+             into a buffer: r8 points in the buffer, r9 counts the samples left.
+            -With FIQ_HANDLER 1, the handler is a C function:
+                void handler(fiqregs_t *regs)
+                {
+                    *(unsigned short *)regs->r8 = (ADDR0 >> 6) & 0x3FF;
+                    regs->r8 += 2;
+                    if(--regs->r9 == 0) {
+                        fiq_stop();
+                    }
+                }
+             'regs' points to the banked registers (stored on the FIQ stack); changes are
+             loaded back into the registers when the handler returns.
+            -With FIQ_HANDLER 2, you provide the assembly function fiq_asmhandler(), which is
+             jumped to straight from the FIQ vector. It runs in ARM mode, and has to clear the
+             interrupt source itself. Only r8-r12 (and the FIQ stack) may be used without
+             saving them. Return with 'subs pc, lr, #4'. fiq_init() is called with NULL as
+             handler in this case.
+            -The interrupt source has to clear it's interrupt flag in the handler, as with
+             an IRQ. There's no need to acknowledge anything in the VIC.
+
+*/
+/*!
+\file
+FIQ fast path, the definitions
+*/
+#ifndef FIQ_H
+#define FIQ_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+#if RUNMODE_USER
+#error "The FIQ functions need a privileged runmode"
+#endif
+
+/*! The banked FIQ registers */
+typedef struct fiqregs {
+    unsigned int r8;
+    unsigned int r9;
+    unsigned int r10;
+    unsigned int r11;
+    unsigned int r12;
+} fiqregs_t;
+
+/*! A C FIQ handler (FIQ_HANDLER 1) */
+typedef void (* FIQFUNCTION)(fiqregs_t *regs);
+
+void fiq_init(const unsigned char channel, const FIQFUNCTION handler);
+void fiq_stop(void);
+/*! Load the banked FIQ registers r8-r12 */
+extern void fiq_setregisters(const fiqregs_t *regs);
+/*! Read the banked FIQ registers r8-r12 */
+extern void fiq_getregisters(fiqregs_t *regs);
+
+#if FIQ_HANDLER == 2
+/*! Your own assembly FIQ handler */
+extern void fiq_asmhandler(void);
+#endif
+
+#endif /* FIQ_H */
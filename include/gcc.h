@@ -60,6 +60,10 @@ GCC extensions
 # define __naked        /* no packed */
 #endif
 
+/* Keep the compiler from moving memory accesses across this point (the ARM7 itself
+   doesn't reorder them), for data shared with interrupt handlers */
+#define barrier()       asm volatile ("" : : : "memory")
+
 #endif /* GCC_H */
 
 /* OK, so what are these? A copy from the information found on the page (note: this is a bit biased towards x86 machines).
@@ -0,0 +1,89 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    initcall.h:
+               Initcall table, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+*/
+/*!
+\file
+Initcall table, the definitions
+*/
+#ifndef INITCALL_H
+#define INITCALL_H
+
+/* Include global configuration */
+#include <config.h>
+#include <debug.h>
+#include <types.h>
+
+/* Initcall levels. init() runs these in order; INITCALL_CORE is the basic system (PLL,
+   VIC, debug console, I/O and watchdog), which init() calls one by one itself */
+#define INITCALL_CORE       0   /* Basic system, only used by init() */
+#define INITCALL_BOARD      1   /* Board support */
+#define INITCALL_DRIVER     3   /* Peripheral drivers */
+#define INITCALL_APP        5   /* Project code */
+#define INITCALL_LATE       7   /* After interrupts are enabled; only run by init() when it enables them */
+#define INITCALL_LAZY       9   /* Not run at boot, but on first use (see initcall_require()) */
+
+/*! Value of initcallstate_t.result for an initcall that hasn't run yet */
+#define INITCALL_NOTRUN     0
+
+typedef struct initcallstate {
+    error_t result;                 /* Returnvalue of the initcall, INITCALL_NOTRUN when not called yet */
+    #if INITCALL_TIMING
+    unsigned int start;             /* Microseconds since init() when the initcall was started.. */
+    unsigned int duration;          /* ..and the amount of microseconds it took */
+    #endif
+} initcallstate_t;
+
+typedef struct initcall {
+    error_t (* function)(void);     /* The function to call */
+    const char *name;               /* It's name, for initcall_report() */
+    initcallstate_t *state;         /* Runtime state, in RAM */
+    unsigned int level;             /* INITCALL_* level */
+} initcall_t;
+
+#define __INITCALL_STR2(x)          #x
+#define __INITCALL_STR(x)           __INITCALL_STR2(x)
+#define __INITCALL(sectionname, level, function) \
+    initcallstate_t __initcallstate_##function; \
+    const initcall_t __initcall_##function __attribute__ ((used, section (sectionname))) = \
+        { function, #function, &__initcallstate_##function, level }
+
+/*! Register 'function' (returning an error_t, no arguments) to be called by init() at
+    the given level. Use this at file scope, in the file where 'function' is defined */
+#define INITCALL(level, function)   __INITCALL(".initcall." __INITCALL_STR(level), level, function)
+
+/*! Register 'function' as a lazy initcall. It is not called at boot; instead, the
+    driver calls initcall_require() before using the hardware, so peripherals that
+    are never used are never set up */
+#define LAZYINITCALL(function)      __INITCALL(".initcall.lazy", INITCALL_LAZY, function)
+
+/*! Declare the initcall 'function', so initcall_require() can be used on it from
+    other files. Put this in the header of the driver that registers it */
+#define INITCALL_DECLARE(function) \
+    extern initcallstate_t __initcallstate_##function; \
+    extern const initcall_t __initcall_##function
+
+/*! Make sure the lazy initcall 'function' (from the same file, or declared with
+    INITCALL_DECLARE()) has been run successfully; returns it's result. Cheap when it
+    already has. */
+#define initcall_require(function)  (__initcallstate_##function.result == GOOD ? GOOD : initcall_call(&__initcall_##function))
+
+/* Function prototypes */
+error_t initcall_call(const initcall_t *initcall);
+void initcall_starttimer(void);
+void initcall_clockchanged(void);
+void initcall_run(const unsigned char from, const unsigned char to);
+void initcall_report(void);
+
+#endif /* INITCALL_H */
@@ -28,10 +28,6 @@ Low level interrupt functions, the definitions
 #include <swi.h>
 #endif
 
-/*! This variable is used by __store_interrupts() and __restore_interrupts() to
-    store the interrupt-status */
-extern unsigned int __interrupt_status;
-
 #if RUNMODE_USER
 #if HANDLE_SWI
 /* 'Normal' code is running in usermode, thus the interrupt functions
@@ -39,6 +35,7 @@ extern unsigned int __interrupt_status;
 #define __enable_interrupts     swi__enable_interrupts
 #define __disable_interrupts    swi__disable_interrupts
 #define __store_interrupts      swi__store_interrupts
+#define __store_interrupts_irq  swi__store_interrupts_irq
 #define __restore_interrupts    swi__restore_interrupts
 #else
 /* Erm.. We're running in usermode, but SWI-handling is disabled? */
@@ -51,10 +48,60 @@ extern void __enable_interrupts(unsigned int IRQorFIQ);
 extern void __disable_interrupts(unsigned int IRQorFIQ);
 /*! Save interruptstatus, then disable them */
 extern void __store_interrupts(interrupt_t *status);
+/*! Save interruptstatus, then disable IRQ (FIQ is left alone) */
+extern void __store_interrupts_irq(interrupt_t *status);
 /*! Restore interruptstatus */
 extern void __restore_interrupts(interrupt_t *status);
 #endif
 
+/*! Critical sections. The interrupt status is kept in a (local) variable of the caller,
+    so these nest properly. In ARM code they're inlined; in thumb code (which has no
+    access to the CPSR) and with RUNMODE_USER, they call the functions above.
+    \code
+    interrupt_t status;
+
+    __critical_enter(status);       // Disable IRQ and FIQ
+    ...
+    __critical_exit(status);        // Back to how it was
+
+    __critical_enter_irq(status);   // Disable IRQ only, FIQ's are still handled
+    ...
+    __critical_exit(status);
+    \endcode
+    'status' holds the I and F bits as they were, the same as __store_interrupts() stores */
+#if defined __thumb__ || RUNMODE_USER
+#define __critical_enter(status)        __store_interrupts(&(status))
+#define __critical_enter_irq(status)    __store_interrupts_irq(&(status))
+#define __critical_exit(status)         __restore_interrupts(&(status))
+#else
+#define __critical_enter(status)        __critical_enter_mask(status, IRQ | FIQ)
+#define __critical_enter_irq(status)    __critical_enter_mask(status, IRQ)
+
+/* Store the I and F bits of the CPSR in 'status', then set the bits in 'mask' */
+#define __critical_enter_mask(status, mask) do { \
+                                            unsigned int __cpsr; \
+                                            asm volatile ("mrs     %1, cpsr\n" \
+                                                          "and     %0, %1, #0xC0\n" \
+                                                          "orr     %1, %1, %2\n" \
+                                                          "msr     cpsr_c, %1\n" \
+                                                          : "=&r" (status), "=&r" (__cpsr) \
+                                                          : "i" (mask) \
+                                                          : "memory"); \
+                                        } while(0)
+
+/* Put the I and F bits from 'status' back in the CPSR */
+#define __critical_exit(status)         do { \
+                                            unsigned int __cpsr; \
+                                            asm volatile ("mrs     %0, cpsr\n" \
+                                                          "bic     %0, %0, #0xC0\n" \
+                                                          "orr     %0, %0, %1\n" \
+                                                          "msr     cpsr_c, %0\n" \
+                                                          : "=&r" (__cpsr) \
+                                                          : "r" (status) \
+                                                          : "memory"); \
+                                        } while(0)
+#endif
+
 /* And two macro's for nested interrupts. The LPC2000 MCU's by themselves don't support nested
    interrupts, but with a little software trick it's still possible (the ARM lpc book contains
    some info about this, see page 75).
@@ -64,7 +111,9 @@ extern void __restore_interrupts(interrupt_t *status);
     should be accompanied by a __disable_nested_interrupts())
    -Be warned that as soon as __enable_nested_interrupts() is called, *every* interrupt can be triggered,
     so that includes the interrupt being handled at that time. This means that you have to clear
-    all interrupt flags before calling __enable_nested_interrupts() */
+    all interrupt flags before calling __enable_nested_interrupts()
+   -Don't use these when IRQ_NESTED is enabled (see config.h); IRQHandler already does this for
+    all handlers then */
 
 /* Enable nested interrupts:
     1. Save current status (IRQ mode)..
@@ -0,0 +1,61 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    irqprofile.h:
+                 Per VIC channel IRQ profiler, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when IRQPROFILE is enabled (see config.h).
+            -All times are in ticks of the IRQPROFILE_TIMER, which is PCLK cycles unless the
+             application changed it's prescaler.
+            -'duration' is the time spent in the handler itself. With IRQ_NESTED, this
+             includes the time spent in higher priority handlers that preempted it.
+            -'latency' is the time from the IRQ exception to the start of the handler. When
+             the IRQ was already waiting at the end of an earlier handler, it's counted from
+             the start of that handler instead: the IRQ may have been requested any time
+             during it, so this is an upper limit. Time spent with interrupts disabled
+             elsewhere cannot be seen, and is not included.
+            -The channel of a vectored IRQ is found by it's handler; when one handler is
+             installed in more than one slot, everything is counted on the first one. The
+             channel of a non-vectored IRQ is the lowest pending channel without a slot.
+
+*/
+/*!
+\file
+Per VIC channel IRQ profiler, the definitions
+*/
+#ifndef IRQPROFILE_H
+#define IRQPROFILE_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+/*! Amount of VIC channels */
+#define IRQPROFILE_CHANNELS     32
+/*! Used for IRQ's of which the channel couldn't be found */
+#define IRQPROFILE_UNKNOWN      IRQPROFILE_CHANNELS
+
+typedef struct irqprofile {
+    unsigned int count;             /* Amount of times the handler was called */
+    unsigned long long total;       /* Total time spent in the handler */
+    unsigned int maxduration;       /* Longest time spent in the handler */
+    unsigned int maxlatency;        /* Longest time before the handler was called */
+} irqprofile_t;
+
+error_t irqprofile_start(void);
+IRQFUNC void irqprofile_dispatch(const FUNCTION handler, const unsigned int entry);
+error_t irqprofile_get(const unsigned char channel, irqprofile_t *profile);
+void irqprofile_reset(void);
+void irqprofile_report(void);
+
+#endif /* IRQPROFILE_H */
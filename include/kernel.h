@@ -0,0 +1,111 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    kernel.h:
+             Preemptive task kernel, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when KERNEL is enabled (see config.h).
+            -Every task has it's own priority, 0 (the highest) to KERNEL_TASKS-2. The highest
+             priority task that's ready runs, until it waits for something or a higher priority
+             task gets ready. There's no time slicing.
+            -kernel_start() turns main() into the idle task, with the lowest priority
+             (KERNEL_TASKS-1). It runs on the System mode stack, whenever no other task is
+             ready, and must never wait: semaphore_wait(), queue_put()/queue_get() with a
+             timeout, and task_sleep() return INVALID there. Calling event_run() (see event.h)
+             or cpu_poweridle() (see power.h) in a loop is a good idea.
+            -Tasks and their stacks are defined with TASK(), so the linker allocates them. The
+             stack is filled with KERNEL_STACKFILL when the task starts, for
+             task_stackunused().
+            -semaphore_post(), queue_put() and queue_get() (without timeout) may be called from
+             IRQ handlers, but not from the FIQ handler. The task switch they cause happens when
+             the IRQ handler is done.
+            -Timeouts and task_sleep() are in ticks, of 1/KERNEL_TICK seconds.
+
+*/
+/*!
+\file
+Preemptive task kernel, the definitions
+*/
+#ifndef KERNEL_H
+#define KERNEL_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+#include <gcc.h>
+#include <err.h>
+
+/*! Maximum amount of tasks, the idle task included */
+#define KERNEL_TASKS        32
+/*! Priority of the idle task (main()) */
+#define KERNEL_IDLE         (KERNEL_TASKS-1)
+
+/*! Timeouts */
+#define KERNEL_NOWAIT       0
+#define KERNEL_FOREVER      0xFFFFFFFF
+
+/*! Unused stack space is filled with this */
+#define KERNEL_STACKFILL    0xA5A5A5A5
+
+typedef void (* TASKFUNCTION)(void *arg);
+
+typedef struct task {
+    unsigned int *sp;               /* Saved stackpointer; must be the first member (see kernelswitch_ARM.S) */
+    unsigned int *stack;            /* Lowest address of the stack.. */
+    unsigned int stacksize;         /* ..and it's size, in bytes */
+    const char *name;
+    unsigned char priority;
+    error_t waitresult;             /* Why the last wait ended: GOOD, or TIMEOUT */
+    unsigned int delay;             /* Ticks left to wait, when it's bit in kernel_delayed is set */
+    volatile unsigned int *waitingon; /* Mask of the semaphore it's waiting on, or NULL */
+} task_t;
+
+/*! Define task 'name' (a task_t), with a stack of 'stacksize' bytes. Start it with
+    task_start(&name, ...) */
+#define TASK(name, stacksize) \
+    static unsigned int name##_stack[((stacksize)+7)/8*2] __attribute__ ((aligned (8))); \
+    task_t name = { NULL, name##_stack, sizeof(name##_stack), #name, 0, GOOD, 0, NULL }
+
+typedef struct semaphore {
+    volatile unsigned int count;
+    volatile unsigned int waiting;  /* Tasks waiting for it, one bit per priority */
+} semaphore_t;
+
+/*! A queue of pointer sized messages. 'buffer' has room for 'length' messages */
+typedef struct queue {
+    void **buffer;
+    unsigned int length;
+    unsigned int readpos;
+    unsigned int writepos;
+    semaphore_t items;              /* Messages in the queue.. */
+    semaphore_t space;              /* ..and free places */
+} queue_t;
+
+error_t kernel_start(void);
+unsigned int kernel_ticks(void);
+void kernel_report(void);
+
+error_t task_start(task_t *task, const TASKFUNCTION function, void *arg, const unsigned char priority);
+task_t *task_current(void);
+error_t task_sleep(const unsigned int ticks);
+unsigned int task_stackunused(const task_t *task);
+
+void semaphore_init(semaphore_t *semaphore, const unsigned int count);
+IRQFUNC error_t semaphore_wait(semaphore_t *semaphore, const unsigned int timeout);
+IRQFUNC void semaphore_post(semaphore_t *semaphore);
+
+void queue_init(queue_t *queue, void **buffer, const unsigned int length);
+IRQFUNC error_t queue_put(queue_t *queue, void *message, const unsigned int timeout);
+IRQFUNC error_t queue_get(queue_t *queue, void **message, const unsigned int timeout);
+
+#endif /* KERNEL_H */
@@ -0,0 +1,55 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    numparse.h:
+               Streaming number parser, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+*/
+/*!
+\file
+Streaming number parser, the definitions
+*/
+#ifndef NUMPARSE_H
+#define NUMPARSE_H
+
+/* Include global configuration */
+#include <config.h>
+#include <types.h>
+#include <ringbuffer.h>
+
+/* Parser states */
+#define NUMPARSE_START      0   /* Nothing but whitespace seen yet */
+#define NUMPARSE_SIGN       1   /* Sign seen, waiting for the first digit */
+#define NUMPARSE_DIGITS     2   /* Busy parsing digits */
+#define NUMPARSE_DONE       3   /* Number complete, value is valid */
+#define NUMPARSE_INVALID    4   /* Got a character that can't be part of the number */
+#define NUMPARSE_OVERFLOW   5   /* Number doesn't fit in 32 bits */
+
+typedef struct numparse {
+    unsigned int value;             /* Value parsed so far (magnitude) */
+    unsigned int cutoff;            /* Largest value that can still be multiplied by base.. */
+    unsigned char cutlim;           /* ..and the largest digit that may be added after that */
+    unsigned char base;             /* Base, 2 to 36 */
+    unsigned char state;            /* One of the NUMPARSE_* states */
+    bool allowsign;                 /* Accept a leading '+' or '-' */
+    bool negative;                  /* A '-' was seen */
+} numparse_t;
+
+error_t numparse_init(numparse_t *parser, const unsigned char base, const bool allowsign);
+unsigned char numparse_putc(numparse_t *parser, const unsigned char c);
+unsigned int numparse_feed(numparse_t *parser, const unsigned char *data, const unsigned int length);
+unsigned int numparse_ringbuffer(numparse_t *parser, ringbufferctrl_t *ringbuffer);
+unsigned char numparse_finish(numparse_t *parser);
+error_t numparse_result(const numparse_t *parser, unsigned int *value);
+#define numparse_state(parser)      ((parser)->state)
+#define numparse_isbusy(parser)     ((parser)->state < NUMPARSE_DONE)
+
+#endif /* NUMPARSE_H */
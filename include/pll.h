@@ -38,11 +38,14 @@ PLL, MAM & VPB initialisation, the definitions
 #define MAMCR_PART    1
 #define MAMCR_FULL    2
 
+#ifndef __ASSEMBLER__
 /* Function prototypes */
 void pll_init(void);
 void pll_switch(unsigned char multiplier);
+unsigned int pll_pclk(void);
 
 #define pll_locked()    (PLLSTAT & PLLSTAT_LOCK)
+#endif /* __ASSEMBLER__ */
 
 
 #endif /* PLL_H */
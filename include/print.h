@@ -22,13 +22,19 @@ Simple printf like function, the definitions
 
 /* Include global configuration */
 #include <config.h>
+#include <stdarg.h>
 
 void (* printputchar)(unsigned char c);
 
 #define print(...)   fprint(printputchar,__VA_ARGS__)
 
+/*! Output function used by print_format(); gets each character, and the 'arg'
+    given to print_format() */
+typedef void (* printout_t)(unsigned char c, void *arg);
+
 /* Function prototypes */
 void print_open(void * localputchar);
+void print_format(const printout_t out, void *arg, char *fmt, va_list argpointer);
 void fprint(void (* localputchar)(unsigned char c), char *fmt, ...);
 unsigned int sprint(char c[], char *fmt, ...);
 
@@ -34,15 +34,18 @@ typedef struct ringbufferctrl {
 
 typedef unsigned char ringbufferdata_t;
 
+/* The functions used from interrupt handlers are marked IRQFUNC, so they're
+   moved to RAM along with those handlers when IRQ_IN_RAM is enabled */
+
 void ringbuffer_init(ringbufferctrl_t *ringbuffer, unsigned char *buffer, unsigned int bufferlength);
-size_t ringbuffer_write(ringbufferctrl_t *ringbuffer, const void *pointer, const size_t size, const size_t length);
-signed short ringbuffer_peek(ringbufferctrl_t *ringbuffer, const size_t offset);
-size_t ringbuffer_read(ringbufferctrl_t *ringbuffer, void *pointer, const size_t size, const size_t length);
+IRQFUNC size_t ringbuffer_write(ringbufferctrl_t *ringbuffer, const void *pointer, const size_t size, const size_t length);
+IRQFUNC signed short ringbuffer_peek(ringbufferctrl_t *ringbuffer, const size_t offset);
+IRQFUNC size_t ringbuffer_read(ringbufferctrl_t *ringbuffer, void *pointer, const size_t size, const size_t length);
 size_t ringbuffer_skip(ringbufferctrl_t *ringbuffer, const size_t size, const size_t length);
 size_t ringbuffer_revert(ringbufferctrl_t *ringbuffer, const size_t size, const size_t length);
-unsigned int ringbuffer_getfreebytes(const ringbufferctrl_t *ringbuffer);
+IRQFUNC unsigned int ringbuffer_getfreebytes(const ringbufferctrl_t *ringbuffer);
 #define ringbuffer_getusedbytes(ringbuffer)     ((ringbuffer->length-1) - ringbuffer_getfreebytes(ringbuffer))
-bool ringbuffer_isfull(const ringbufferctrl_t *ringbuffer);
-bool ringbuffer_isempty(const ringbufferctrl_t *ringbuffer);
+IRQFUNC bool ringbuffer_isfull(const ringbufferctrl_t *ringbuffer);
+IRQFUNC bool ringbuffer_isempty(const ringbufferctrl_t *ringbuffer);
 
 #endif /* _RINGBUFFER_H_ */
@@ -68,7 +68,7 @@ RTC driver definitions
 #define RTC_BYEAR                (1<<7)
 
 /* Function prototypes */
-void rtc_init(const bool reset, const bool use_external_clk, const FUNCTION counter_callback, const FUNCTION alarm_callback);
+error_t rtc_init(const bool reset, const bool use_external_clk, const FUNCTION counter_callback, const FUNCTION alarm_callback);
 void rtc_setcounterinterrupts(const unsigned char bits);
 void rtc_setalarm(const rtc_t rtc, const unsigned char maskbits);
 void rtc_get(rtc_t *rtc);
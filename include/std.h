@@ -23,6 +23,23 @@ Some all-around functions, the definitions
 /* Include global configuration */
 #include <config.h>
 
+/*! Returned by digitvalue() for characters that are not a digit in any base */
+#define STD_NODIGIT         0xFF
+
+extern const unsigned char std_digitvalue[128];
+
+/*! Value of the ASCII character 'c' as a digit (0 to 35, letters in either case
+    being 10 and up), or STD_NODIGIT. A character is a valid digit in a given base
+    when digitvalue(c) < base */
+#define digitvalue(c)       (((unsigned char)(c)) < 128 ? std_digitvalue[(unsigned char)(c)] : STD_NODIGIT)
+
+extern const unsigned char std_debruijn[32];
+
+/*! Number of the lowest set bit in 'x', which must not be 0. The ARM7 has no CLZ instruction;
+    'x & -x' leaves only that bit, and multiplying it with a De Bruijn sequence puts a
+    different pattern in the upper 5 bits for each of the 32 bits. 'x' is evaluated twice */
+#define lowestbit(x)        std_debruijn[(((unsigned int)(x) & -(unsigned int)(x)) * 0x077CB531U) >> 27]
+
 /* Function prototypes */
 unsigned char inttostr(unsigned int num, char *c, const unsigned char base);
 unsigned int strtoint(char *c, const unsigned char base);
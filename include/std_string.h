@@ -22,11 +22,29 @@ Some basic string functions
 
 /* Include global configuration */
 #include <config.h>
+#include <stddef.h>
+
+/*! Returned by strpos() when the needle isn't found */
+#define STRPOS_NOTFOUND     0xFFFFFFFF
 
 unsigned int strlen(const char *s);
 char *strcat(char *dest, const char *src);
 char *strcpy(char *dest, const char *src);
-char *strncpy(char *dest, const char *src, int n);
+char *strncpy(char *dest, const char *src, size_t n);
 unsigned int strpos(char *haystack, char *needle);
+int strcmp(const char *s1, const char *s2);
+char *strstr(const char *haystack, const char *needle);
+char *strchr(const char *s, int c);
+char *strrchr(const char *s, int c);
+unsigned int strnlen(const char *s, size_t maxlen);
+int strncmp(const char *s1, const char *s2, size_t n);
+char *strncat(char *dest, const char *src, size_t n);
+
+/* Block memory functions. memcmp() is found in std_string.c, the others
+   are written in assembler (see std_string_ARM.S) */
+void *memcpy(void *dest, const void *src, size_t n);
+void *memmove(void *dest, const void *src, size_t n);
+void *memset(void *s, int c, size_t n);
+int memcmp(const void *s1, const void *s2, size_t n);
 
 #endif /* STD_STRING_H */
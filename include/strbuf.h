@@ -0,0 +1,45 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    strbuf.h:
+             Length-tracking string builder, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+*/
+/*!
+\file
+Length-tracking string builder, the definitions
+*/
+#ifndef STRBUF_H
+#define STRBUF_H
+
+/* Include global configuration */
+#include <config.h>
+#include <types.h>
+
+typedef struct strbuf {
+    char *data;                     /* Points to the buffer */
+    unsigned int size;              /* Size of the buffer, including room for the '\0' */
+    unsigned int length;            /* Current length of the string in the buffer */
+    bool truncated;                 /* Set when something did not fit in the buffer */
+} strbuf_t;
+
+void strbuf_init(strbuf_t *strbuf, char *buffer, const unsigned int buffersize);
+void strbuf_clear(strbuf_t *strbuf);
+error_t strbuf_addchar(strbuf_t *strbuf, const char c);
+error_t strbuf_addstr(strbuf_t *strbuf, const char *s);
+error_t strbuf_addnum(strbuf_t *strbuf, const unsigned int num, const unsigned char base);
+error_t strbuf_addf(strbuf_t *strbuf, char *fmt, ...);
+#define strbuf_string(strbuf)       ((strbuf)->data)
+#define strbuf_length(strbuf)       ((strbuf)->length)
+#define strbuf_getfreebytes(strbuf) ((strbuf)->size - 1 - (strbuf)->length)
+#define strbuf_istruncated(strbuf)  ((strbuf)->truncated)
+
+#endif /* STRBUF_H */
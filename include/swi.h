@@ -28,9 +28,10 @@ Software interrupt handling, the definitions
 #define SWI_INT_DISABLE     1
 #define SWI_INT_STORE       2
 #define SWI_INT_RESTORE     3
+#define SWI_INT_STOREIRQ    4
 
 /* No. of SWI commands */
-#define SWI_MAX             4
+#define SWI_MAX             5
 
 /* SWI user functions */
 #ifndef __ASSEMBLER__
@@ -42,6 +43,8 @@ extern void swi__disable_interrupts(unsigned int IRQorFIQ);
 extern void swi__store_interrupts(interrupt_t *status);
 /*! Restore interruptstatus */
 extern void swi__restore_interrupts(interrupt_t *status);
+/*! Save interruptstatus, then disable IRQ */
+extern void swi__store_interrupts_irq(interrupt_t *status);
 #endif
 
 #endif /* SWI_H */
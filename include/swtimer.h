@@ -0,0 +1,69 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    swtimer.h:
+              Software timers, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when SWTIMER is enabled (see config.h).
+            -Any amount of one-shot or periodic timers run on one hardware timer. Starting and
+             stopping one takes the same time, however many there are.
+            -There's no fixed tick; the hardware timer interrupts only when a timer expires
+             (and at least every SWTIMER_MAXTICKS, to keep track of time).
+            -The callbacks are called from the timer interrupt, so keep them short (or hand
+             the work to defer_post(), see defer.h). They may start and stop timers,
+             including their own.
+            -All times are in ticks of SWTIMER_USEC microseconds.
+
+*/
+/*!
+\file
+Software timers, the definitions
+*/
+#ifndef SWTIMER_H
+#define SWTIMER_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+#include <initcall.h>
+
+/*! Longest time a timer can be started for, in ticks */
+#define SWTIMER_MAXTICKS        ((1<<29)-1)
+
+/*! Convert microseconds and milliseconds to ticks. Round up, so a timer never
+    expires early */
+#define SWTIMER_USECS(us)       (((us)+SWTIMER_USEC-1)/SWTIMER_USEC)
+#define SWTIMER_MSECS(ms)       SWTIMER_USECS((ms)*1000)
+
+typedef void (* SWTIMERFUNCTION)(void *arg);
+
+typedef struct swtimer {
+    struct swtimer *next;           /* Next timer in the same slot */
+    struct swtimer **pprev;         /* What points to this one; NULL when not running */
+    unsigned long long expires;     /* When it expires, in ticks since startup */
+    unsigned int period;            /* Ticks between expiries, 0 for a one-shot timer */
+    SWTIMERFUNCTION function;       /* Callback.. */
+    void *arg;                      /* ..and it's argument */
+    unsigned char level;            /* Where it is in the wheel */
+    unsigned char slot;
+} swtimer_t;
+
+error_t swtimer_startclock(void);
+INITCALL_DECLARE(swtimer_startclock);
+void swtimer_init(swtimer_t *timer, const SWTIMERFUNCTION function, void *arg);
+IRQFUNC error_t swtimer_start(swtimer_t *timer, const unsigned int ticks, const unsigned int period);
+IRQFUNC void swtimer_stop(swtimer_t *timer);
+bool swtimer_running(const swtimer_t *timer);
+unsigned long long swtimer_now(void);
+
+#endif /* SWTIMER_H */
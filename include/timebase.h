@@ -0,0 +1,61 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    timebase.h:
+               System time, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when TIMEBASE is enabled (see config.h).
+            -The time counts up from startup in 64 bits, so it never wraps. Use it for time
+             stamps, latency measurements and timeouts instead of reading a timer directly:
+             \code
+             unsigned long long start = time_now_ticks();
+             ...
+             if(time_now_ticks() - start >= time_ms_to_ticks(10)) {
+             \endcode
+            -A tick is 1/(1<<TIMEBASE_SHIFT) microsecond, so the conversions are shifts (and,
+             for milliseconds, a multiplication).
+            -time_now_ticks() may be called from IRQ handlers.
+            -time_waituntil() waits for a point in time, in idle mode when it's far enough
+             away; delay_us() and friends (see delay.h) use it. It needs the timer interrupt,
+             so not before time_init(), with IRQ disabled or from interrupt handlers;
+             time_canwait() tells.
+
+*/
+/*!
+\file
+System time, the definitions
+*/
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+/*! Ticks per microsecond */
+#define TIMEBASE_TICKSPERUSEC       (1<<TIMEBASE_SHIFT)
+
+/*! Conversions between ticks, microseconds and milliseconds. The results are 64 bit */
+#define time_us_to_ticks(us)        ((unsigned long long)(us) << TIMEBASE_SHIFT)
+#define time_ms_to_ticks(ms)        time_us_to_ticks((unsigned long long)(ms) * 1000)
+#define time_ticks_to_us(ticks)     ((unsigned long long)(ticks) >> TIMEBASE_SHIFT)
+
+/*! Return the amount of microseconds since startup */
+#define time_now_us()               time_ticks_to_us(time_now_ticks())
+
+error_t time_init(void);
+IRQFUNC unsigned long long time_now_ticks(void);
+bool time_canwait(void);
+void time_waituntil(const unsigned long long until);
+
+#endif /* TIMEBASE_H */
@@ -0,0 +1,56 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    timerpwm.h:
+               Timer PWM driver definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when TIMERPWM is enabled (see config.h).
+            -On the LPC2101/2/3, the match outputs of the timers have a PWM mode; this driver
+             uses the one of TIMERPWM_TIMER, next to (or instead of) the PWM driver (pwm.h).
+             Used the same way: timerpwm_init(), then timerpwm_chan_init() for every channel.
+            -MR3 sets the period, shared by channels 0 to 2 (MATx.0 to MATx.2).
+            -A new duty cycle takes effect at the start of the next period (or the one after
+             that, when it's set just before the end), so a period is never cut short or
+             stretched.
+            -Select the MAT function of the pins in PINSEL yourself.
+
+*/
+/*!
+\file
+Timer PWM driver definitions
+*/
+#ifndef TIMERPWM_H
+#define TIMERPWM_H
+
+/* Include global configuration */
+#include <config.h>
+
+/* This driver is known to work (or is very likely to do so) on the following MCU's */
+#if (__MCU >= LPC2101 && __MCU <= LPC2103) || (defined __DOXYGEN__)
+#define TIMERPWM_ENABLED
+
+#include <types.h>
+
+/* The timer PWM channels */
+#define TIMERPWM0   0
+#define TIMERPWM1   1
+#define TIMERPWM2   2
+#define TIMERPWM_CHANNELS   3
+
+/* Function prototypes */
+error_t timerpwm_set(const unsigned int chan, const unsigned int duty);
+error_t timerpwm_chan_init(const unsigned int chan, const unsigned int initduty);
+error_t timerpwm_init(const unsigned int nticks, const unsigned int tickcycles);
+
+#endif
+
+#endif /* TIMERPWM_H */
@@ -49,10 +49,40 @@ Global type definitions
 #define RAMFUNC
 #endif
 
+/*! Functions on the interrupt path, such as interrupt handlers and the functions
+    they call. These are placed in RAM when IRQ_IN_RAM is enabled (see config.h),
+    and left alone otherwise. Use it like RAMFUNC, on the prototype only:
+    \code
+    IRQFUNC void timer0_handler(void);
+    \endcode */
+#if defined __RUN_FROM_ROM && IRQ_IN_RAM
+#define IRQFUNC RAMFUNC
+#else
+#define IRQFUNC
+#endif
+
 /* Following are used for the 'IRQorFIQ' argument from vic_setup(),
    and the __enable_interrupts() call */
 #define IRQ         0x80
 #define FIQ         0x40
+#if IRQ_DIRECT
+/*! Flag for the 'IRQorFIQ' argument of vic_setup(), to install a direct handler:
+    \code
+    vic_setup(VIC_CH_TIMER0, IRQ | IRQDIRECT, PRIO_TIMER0, timer0_handler);
+    \endcode
+    Only available when IRQ_DIRECT is enabled (see config.h) */
+#define IRQDIRECT   0x01
+#endif
+
+/*! Handlers installed with IRQDIRECT are jumped to straight from the IRQ vector, so
+    they have to save the registers they use and return from the exception themselves.
+    GCC takes care of that for functions declared as follows. These must be compiled
+    in ARM mode (put them in a *_ARM.c file), and call vic_acknowledge() (see vic.h)
+    before they return. Use it on the prototype, like IRQFUNC (both may be combined):
+    \code
+    IRQDIRECTFUNC void timer0_handler(void);
+    \endcode */
+#define IRQDIRECTFUNC __attribute__ ((interrupt ("IRQ")))
 
 /* Reset causes (as returned by getresetcause(), init.c) */
 #define RESET_POWERUP   0
@@ -20,12 +20,24 @@ VIC driver definitions
 #ifndef VIC_H
 #define VIC_H
 
+/* Include global configuration */
+#include <config.h>
+
 /*! Peripheral priorities. When two or more VIC interrupts occur at the same time, the first slot
     (thus the lowest number) will be handled first. There are 16 slots, numered from 0 (the first)
     to 15. Each slot can handle only one interrupt source.
     There are, indeed, not enough channels to handle all sources. Giving a priority > 15 (or PRIO_NONVECTOR)
     will result in a non-vectored IRQ (which you'll have to program yourself */
 
+/* Slots of peripherals the selected MCU doesn't have. A driver pushed out of it's own slot by
+   one of the software interrupts (PRIO_DEFER, PRIO_KERNEL) gets one of these instead */
+#if (__MCU >= LPC2101 && __MCU <= LPC2103)
+#define PRIO_SPARE0                         9   // No PWM block
+#else
+#define PRIO_SPARE0                         7   // No timer 2..
+#define PRIO_SPARE1                         8   // ..and 3
+#endif
+
 /* External interrupts */
 #define PRIO_EINT0                          0
 #define PRIO_EINT1                          1
@@ -69,13 +81,44 @@ VIC driver definitions
    interrupts */
 #define PRIO_SSP                            13
 /* RTC counter increment and alarm
-   interrupts */
+   interrupts. Moves to a spare slot when
+   both software interrupts are used; the
+   LPC2101/2/3 have none left for it, so
+   rtc_init() refuses then */
+#if KERNEL && DEFER_SOFTINT && defined PRIO_SPARE1
+#define PRIO_RTC                            PRIO_SPARE1
+#else
 #define PRIO_RTC                            14
-/* ADC0 conversion complete interrupt */
+#endif
+/* ADC0 conversion complete interrupt.
+   Moves to a spare slot when the lowest
+   one is taken by a software interrupt */
+#if DEFER_SOFTINT || KERNEL
+#define PRIO_ADC                            PRIO_SPARE0
+#else
 #define PRIO_ADC                            15
+#endif
 #define PRIO_ADC0 PRIO_ADC
+/* Deferred work software interrupt (see
+   defer.h), should be the lowest priority
+   in use. With the kernel, it's one slot
+   up, in the RTC's slot */
+#if KERNEL && DEFER_SOFTINT
+#define PRIO_DEFER                          14
+#else
+#define PRIO_DEFER                          15
+#endif
+/* Task switch software interrupt (see
+   kernel.h), must be the lowest priority
+   in use */
+#define PRIO_KERNEL                         15
 /* ADC1 conversion complete interrupt */
 #define PRIO_ADC1                           PRIO_NONVECTOR
+
+/*! True when 'priority' is the slot of a software interrupt in use. Drivers check this before
+    installing their handler, and refuse when it is */
+#define vic_softintslot(priority)           ((DEFER_SOFTINT && (priority) == PRIO_DEFER) || \
+                                             (KERNEL && (priority) == PRIO_KERNEL))
 /* USB */
 #define PRIO_USB                            1
 /* Watchdog interrupt */
@@ -88,9 +131,6 @@ VIC driver definitions
 /* Brown out detect */
 #define PRIO_BOD                            PRIO_NONVECTOR
 
-/* Include global configuration */
-#include <config.h>
-
 #include <types.h>
 #include "drivers/registers.h"
 
@@ -99,6 +139,18 @@ VIC driver definitions
 #define PRIO_MIN            15
 #define PRIO_NONVECTOR      16
 
+/* Set in VICVectCntl when a slot is in use; the lower bits hold the channel */
+#define SLOT_ENABLED        0x20
+
+/*! Priority classes, for vic_setupclass(). Each is the first slot of the class;
+    the class runs up to the next one */
+#define PRIOCLASS_HIGH      0
+#define PRIOCLASS_NORMAL    4
+#define PRIOCLASS_LOW       12
+
+/* Amount of VIC channels */
+#define VIC_CHANNELS        32
+
 /* VIC channels */
 #define VIC_CH_WDT          0
 #define VIC_CH_DBGCOMMRX    2
@@ -129,10 +181,44 @@ VIC driver definitions
 #define VIC_CH_TIMER2       26
 #define VIC_CH_TIMER3       27
 
-/*! To change the default IRQ handler without calling vic_init(), use the following */
-#define vic_setdefaulthandler(handler)  do { \
+#if IRQ_DIRECT
+/* Handlers called by the IRQ stubs in crt0.S, and the addresses of those stubs (see vic.c) */
+extern FUNCTION __vic_handlers[PRIO_NONVECTOR+1];
+extern const unsigned int __irq_slots[PRIO_NONVECTOR+1];
+
+/* Install the non-vectored IRQ handler */
+#define __vic_setdefvectaddr(handler)   do { \
+                                            __vic_handlers[PRIO_NONVECTOR] = handler; \
+                                            VICDefVectAddr = __irq_slots[PRIO_NONVECTOR]; \
+                                        } while(0)
+#else
+/* Install the non-vectored IRQ handler */
+#define __vic_setdefvectaddr(handler)   do { \
                                             VICDefVectAddr = (unsigned int)handler; \
                                         } while(0)
+#endif
+
+#if VIC_DISPATCH
+/* Handlers of the non-vectored channels, and which channels have one (see vic.c) */
+extern FUNCTION vic_channelhandlers[VIC_CHANNELS];
+extern unsigned int vic_nonvectored;
+extern FUNCTION vic_unhandled;
+
+/*! To change the default IRQ handler without calling vic_init(), use the following. With
+    VIC_DISPATCH, it's called for non-vectored IRQ's without a handler of their own */
+#define vic_setdefaulthandler(handler)  do { \
+                                            vic_unhandled = handler; \
+                                        } while(0)
+#else
+/*! To change the default IRQ handler without calling vic_init(), use the following */
+#define vic_setdefaulthandler(handler)  __vic_setdefvectaddr(handler)
+#endif
+
+/*! Direct handlers (see IRQDIRECT in types.h) have to tell the VIC they're done
+    with this, right before they return */
+#define vic_acknowledge()               do { \
+                                            VICVectAddr = 0xFF; \
+                                        } while(0)
 
 /*! The following is true when the given channel is enabled, false otherwise */
 #define vic_channelenabled(channel)     (VICIntEnable & (1<<channel))
@@ -142,6 +228,9 @@ void vic_setup(const unsigned char channel, const unsigned char IRQorFIQ, const
 void vic_disablechannel(const unsigned int channel);
 void vic_enablechannel(const unsigned int channel);
 unsigned char vic_gethighestfreepriority(void);
+unsigned char vic_getfreepriority(const unsigned char first);
+unsigned char vic_setupclass(const unsigned char channel, const unsigned char prioclass, const FUNCTION handler);
 unsigned char vic_getpriority(const unsigned char channel);
+unsigned int vic_gethandler(const unsigned char priority);
 
 #endif /* VIC_H */
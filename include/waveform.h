@@ -0,0 +1,57 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    waveform.h:
+               Match output waveforms, the definitions
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -Only available when WAVEFORM is enabled (see config.h).
+            -The edges are made by the timer itself (the external match outputs, MATx.0 to
+             MATx.3), so there's no interrupt involved, and no jitter.
+            -Square waves: all channels toggle once every half period, each at it's own phase
+             within that half period. MR3 sets the half period, so MATx.3 can't be used for
+             them. Two channels a quarter period apart make a quadrature (stepper) signal:
+             \code
+             waveform_init(PCLK_ONE_USEC-1);     // 1 uSec ticks
+             waveform_channel(0, 0);
+             waveform_channel(1, 250);
+             waveform_square(500);               // 1kHz
+             \endcode
+            -Pulses: waveform_pulse() raises the output and has the timer lower it again after
+             exactly 'width' ticks. It stops the square waves.
+            -Select the MAT function of the pins in PINSEL yourself; which pin that is
+             differs per MCU.
+
+*/
+/*!
+\file
+Match output waveforms, the definitions
+*/
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+/* Include global configuration */
+#include <config.h>
+
+#include <types.h>
+
+/*! Match outputs of a timer */
+#define WAVEFORM_CHANNELS       4
+
+error_t waveform_init(const unsigned int prescaler);
+error_t waveform_channel(const unsigned char channel, const unsigned int phase);
+error_t waveform_square(const unsigned int halfperiod);
+error_t waveform_pulse(const unsigned char channel, const unsigned int width);
+bool waveform_busy(void);
+void waveform_stop(void);
+error_t waveform_set(const unsigned char channel, const bool level);
+
+#endif /* WAVEFORM_H */
@@ -0,0 +1,152 @@
+/*
+    ALDS (ARM LPC Driver Set)
+
+    datacompress.c:
+                   Compress the data section image, for COMPRESSDATA (see the Makefile)
+
+    copyright:
+              Copyright (c) 2006-2007 Bastiaan van Kesteren <bastiaanvankesteren@gmail.com>
+
+              This program comes with ABSOLUTELY NO WARRANTY; for details see the file LICENSE.
+              This program is free software; you can redistribute it and/or modify it under the terms
+              of the GNU General Public License as published by the Free Software Foundation; either
+              version 2 of the License, or (at your option) any later version.
+
+    remarks:
+            -This runs on the build host, not on the target! It's compiled and executed
+             from the Makefile.
+            -The format is a simple LZ77/run-length mix, chosen so the decompressor in
+             crt0.S stays small. The stream is a sequence of tokens:
+                0x00-0x7F   literal; copy the next (token + 1) bytes
+                0x80-0xBF   fill; repeat the next byte (token - 0x80 + 3) times
+                0xC0-0xFF   match; copy (token - 0xC0 + 3) bytes from 'offset' bytes back
+                            in the output. 'offset' follows as two bytes, little endian
+             There's no end marker; the decompressor stops when the whole data section is
+             filled in.
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAXLITERAL      128
+#define MINRUN          3
+#define MAXRUN          66
+#define MAXOFFSET       0xFFFF
+#define HASHSIZE        4096
+#define MAXCHAIN        256
+
+static unsigned char *in, *out;
+static long insize, outsize;
+static long literalstart, literalcount;
+
+static void flushliterals(void)
+{
+    while(literalcount > 0) {
+        long n = literalcount > MAXLITERAL ? MAXLITERAL : literalcount;
+
+        out[outsize++] = n - 1;
+        memcpy(out + outsize, in + literalstart, n);
+        outsize += n;
+        literalstart += n;
+        literalcount -= n;
+    }
+}
+
+static unsigned int hash(const long pos)
+{
+    return ((in[pos] << 8) ^ (in[pos+1] << 4) ^ in[pos+2]) % HASHSIZE;
+}
+
+int main(int argc, char *argv[])
+{
+    static long head[HASHSIZE];
+    long *prev;
+    long pos, i, candidate, len, run, bestlen, bestoffset, chain;
+    FILE *f;
+
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s <raw data> <compressed data>\n", argv[0]);
+        return 1;
+    }
+
+    /* Read the raw data section */
+    if((f = fopen(argv[1], "rb")) == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    insize = ftell(f);
+    rewind(f);
+    in = malloc(insize + 1);
+    out = malloc(insize + insize/MAXLITERAL + 2);
+    prev = malloc((insize + 1) * sizeof(long));
+    if(in == NULL || out == NULL || prev == NULL || fread(in, 1, insize, f) != (size_t)insize) {
+        fprintf(stderr, "%s: read error\n", argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    for(i=0;i<HASHSIZE;i++) {
+        head[i] = -1;
+    }
+
+    pos = 0;
+    while(pos < insize) {
+        /* A run of the same byte? */
+        for(run=1; pos+run < insize && run < MAXRUN && in[pos+run] == in[pos]; run++);
+
+        /* Longest earlier match, following the hash chain */
+        bestlen = 0;
+        bestoffset = 0;
+        if(pos + MINRUN <= insize) {
+            for(candidate=head[hash(pos)], chain=0; candidate >= 0 && pos-candidate <= MAXOFFSET && chain < MAXCHAIN; candidate=prev[candidate], chain++) {
+                for(len=0; pos+len < insize && len < MAXRUN && in[candidate+len] == in[pos+len]; len++);
+                if(len > bestlen) {
+                    bestlen = len;
+                    bestoffset = pos - candidate;
+                }
+            }
+        }
+
+        if(run >= MINRUN && run >= bestlen) {
+            flushliterals();
+            out[outsize++] = 0x80 + run - MINRUN;
+            out[outsize++] = in[pos];
+            len = run;
+        }
+        else if(bestlen >= MINRUN) {
+            flushliterals();
+            out[outsize++] = 0xC0 + bestlen - MINRUN;
+            out[outsize++] = bestoffset & 0xFF;
+            out[outsize++] = bestoffset >> 8;
+            len = bestlen;
+        }
+        else {
+            if(literalcount == 0) {
+                literalstart = pos;
+            }
+            literalcount++;
+            len = 1;
+        }
+
+        /* Add all covered positions to the hash chains */
+        for(i=0;i<len;i++,pos++) {
+            if(pos + MINRUN <= insize) {
+                prev[pos] = head[hash(pos)];
+                head[hash(pos)] = pos;
+            }
+        }
+    }
+    flushliterals();
+
+    if((f = fopen(argv[2], "wb")) == NULL || fwrite(out, 1, outsize, f) != (size_t)outsize) {
+        perror(argv[2]);
+        return 1;
+    }
+    fclose(f);
+
+    printf("Data section compressed from %ld to %ld bytes (saves %ld bytes of flash)\n", insize, outsize, insize - outsize);
+
+    return 0;
+}